@@ -3,8 +3,12 @@
 #include "SXICore/ECS/Settings.h"
 #include "SXICore/components/PositionComponent.h"
 #include "SXICore/components/YRotationComponent.h"
+#include "SXICore/components/HierarchyComponent.h"
+#include "SXICore/components/WorldTransformComponent.h"
 #include "SXIRenderer/components/RenderComponent.h"
+#include "SXIRenderer/resources/CameraResource.h"
 #include "SXIRenderer/tags/LightTag.h"
+#include "SXICore/Timing.h"
 
 #include "SXICore/MPL/Filter.h"
 #include "SXICore/MPL/Contains.h"
@@ -12,6 +16,8 @@
 using Components = sxi::ecs::ComponentList<
     sxi::ecs::PositionComponent,
     sxi::ecs::YRotationComponent,
+    sxi::ecs::HierarchyComponent,
+    sxi::ecs::WorldTransformComponent,
     sxi::ecs::RenderComponent>;
 
 struct ObjectTag{};
@@ -20,6 +26,8 @@ using Tags = sxi::ecs::TagList<sxi::ecs::LightTag, ObjectTag>;
 using Object = sxi::ecs::Archetype<
     sxi::ecs::PositionComponent,
     sxi::ecs::YRotationComponent,
+    sxi::ecs::HierarchyComponent,
+    sxi::ecs::WorldTransformComponent,
     sxi::ecs::RenderComponent,
     ObjectTag>;
 using Light = sxi::ecs::Archetype<
@@ -27,11 +35,11 @@ using Light = sxi::ecs::Archetype<
     sxi::ecs::LightTag>;
 using Archetypes = sxi::ecs::ArchetypeList<Object, Light>;
 
-using RotateSignature = sxi::ecs::Signature<sxi::ecs::YRotationComponent, ObjectTag>;
-using MoveSignature = sxi::ecs::Signature<sxi::ecs::PositionComponent, ObjectTag>;
+// children follow their parent through TransformPropagation, so only roots are animated
+using RotateSignature = sxi::ecs::Signature<sxi::ecs::YRotationComponent, sxi::ecs::HierarchyComponent, ObjectTag>;
+using MoveSignature = sxi::ecs::Signature<sxi::ecs::PositionComponent, sxi::ecs::HierarchyComponent, ObjectTag>;
 using CalculateDescriptorsSignature = sxi::ecs::Signature<
-    sxi::ecs::PositionComponent,
-    sxi::ecs::YRotationComponent,
+    sxi::ecs::WorldTransformComponent,
     sxi::ecs::RenderComponent>;
 using LightSignature = sxi::ecs::Signature<
     sxi::ecs::PositionComponent,
@@ -44,4 +52,32 @@ using Signatures = sxi::ecs::SignatureList<
     RenderSignature,
     LightSignature>;
 
-using ECSSettings = sxi::ecs::Settings<Components, Tags, Archetypes, Signatures>;
\ No newline at end of file
+using ChunkedArchetypes = sxi::ecs::ArchetypeList<Object>;
+using TrackedComponents = sxi::ecs::ComponentList<
+    sxi::ecs::PositionComponent,
+    sxi::ecs::YRotationComponent,
+    sxi::ecs::WorldTransformComponent>;
+
+// the light circles the scene, starting when the world is created
+struct LightOrbitResource final
+{
+    sxi::TimePoint start = sxi::Clock::now();
+    float radius = 100.f;
+    float height = 30.f;
+};
+
+using Resources = sxi::ecs::ResourceList<
+    sxi::Time,
+    sxi::ecs::CameraResource,
+    LightOrbitResource>;
+
+struct ECSSettings final : sxi::ecs::Settings<
+    Components,
+    Tags,
+    Archetypes,
+    Signatures,
+    ChunkedArchetypes,
+    TrackedComponents,
+    sxi::ecs::MigrationList<>,
+    sxi::ecs::ColumnAllocator<>,
+    Resources> {};
\ No newline at end of file
@@ -6,16 +6,21 @@
 #include <string>
 #include <vector>
 #include <tuple>
+#include <utility>
 #include <span>
 #include <limits>
+#include <cmath>
 
 #include "SXIMath/Vec.h"
 
 #include "SXIRenderer/Renderer.h"
 #include "SXICore/File.h"
 #include "SXICore/Timing.h"
+#include "SXICore/Profiler.h"
 
 #include "SXICore/ECS/Manager.h"
+#include "SXICore/ECS/Scheduler.h"
+#include "SXICore/systems/TransformPropagation.h"
 #include "ECSSettings.h"
 
 const std::string MODELS_PATH = "../../MysteriousGame/models/";
@@ -25,9 +30,62 @@ const std::string SHADERS_GEN_PATH = "../../MysteriousGame/shaders/generated/";
 
 static sxi::ecs::Manager<ECSSettings> mgr;
 
+struct MoveSystem : sxi::ecs::System<MoveSignature, sxi::ecs::ReadList<sxi::Time, sxi::ecs::HierarchyComponent>>
+{
+	void run(sxi::ecs::Manager<ECSSettings>& mgr)
+	{
+		const sxi::Time& time = mgr.resource<sxi::Time>();
+		// positions are split, so only the y column is touched
+		mgr.forChunksMatching<MoveSignature, Reads>([&time](auto, sxi::ecs::SplitSpan<sxi::ecs::PositionComponent> posComponents,
+			std::span<const sxi::ecs::HierarchyComponent> hierarchies){
+			std::span<float> ys = posComponents.field<1>();
+			for (size_t i = 0; i < ys.size(); ++i)
+				if (hierarchies[i].parent.empty())
+					ys[i] += 1 * time.dt;
+		});
+	}
+};
+
+struct RotateSystem : sxi::ecs::System<RotateSignature, sxi::ecs::ReadList<sxi::Time, sxi::ecs::HierarchyComponent>>
+{
+	void run(sxi::ecs::Manager<ECSSettings>& mgr)
+	{
+		const float dRot = 0.1f * mgr.resource<sxi::Time>().dt;
+		mgr.forChunksMatching<RotateSignature, Reads>([dRot](auto, std::span<sxi::ecs::YRotationComponent> yRotComponents,
+			std::span<const sxi::ecs::HierarchyComponent> hierarchies){
+			for (size_t i = 0; i < yRotComponents.size(); ++i)
+				if (hierarchies[i].parent.empty())
+					yRotComponents[i].rot += dRot;
+		});
+	}
+};
+
+struct OrbitLightSystem : sxi::ecs::System<LightSignature, sxi::ecs::ReadList<sxi::Time, LightOrbitResource>>
+{
+	void run(sxi::ecs::Manager<ECSSettings>& mgr)
+	{
+		const LightOrbitResource& orbit = mgr.resource<LightOrbitResource>();
+		const float timePassed = -sxi::Time::elapsed(mgr.resource<sxi::Time>().time, orbit.start);
+		const sxi::ecs::PositionComponent position{ glm::vec3(orbit.radius * std::sin(timePassed), orbit.height, orbit.radius * std::cos(timePassed)) };
+		// positions are split, so the proxy takes the whole component at once
+		mgr.forEntitiesMatching<LightSignature>([&position](auto, auto&& posComponent){
+			posComponent = position;
+		});
+	}
+};
+
+using Systems = sxi::ecs::SystemList<
+	MoveSystem,
+	RotateSystem,
+	OrbitLightSystem,
+	sxi::ecs::TransformPropagation<ECSSettings, Object>>;
+static sxi::ecs::Scheduler<ECSSettings, Systems> scheduler;
+
 static void loop()
 {
-	sxi::Time time{};
+	sxi::profiler::setThreadName("Main");
+	// draws each frame on its own thread while the next one is simulated
+	sxi::renderer::FramePipeline pipeline{};
 	SDL_Event e;
 	SDL_zero(e);
 	bool minimized = false;
@@ -49,22 +107,27 @@ static void loop()
 			{
 				if (e.key.key == SDLK_ESCAPE)
 					return;
+
+				// F1 toggles recording, F2 dumps the recent frames for about:tracing
+				if (e.key.key == SDLK_F1)
+					sxi::profiler::setEnabled(!sxi::profiler::enabled());
+
+				if (e.key.key == SDLK_F2)
+					sxi::profiler::writeChromeTrace(std::string("trace.json"));
 			}
 		}
 		// if (!minimized)
 		// 	renderer->render(time);
 
-		mgr.forEntitiesMatching<MoveSignature>([&time](auto&, auto& posComponent){
-			posComponent.pos.y += 1 * time.dt;
-		});
+		scheduler.run(mgr);
 
-		mgr.forEntitiesMatching<RotateSignature>([&time](auto&, auto& yRotComponent){
-			yRotComponent.rot += 0.1 * time.dt;
-		});
-
-		sxi::renderer::render(mgr, time);
+		pipeline.submit(mgr);
 		mgr.refresh();
-		time.refresh();
+		// keeps objects sharing a model and texture next to each other in the draw list
+		mgr.sortBy<Object, sxi::ecs::RenderComponent>([](const sxi::ecs::RenderComponent& render){
+			return std::pair<size_t, size_t>(render.mdl, render.tex);
+		});
+		mgr.resource<sxi::Time>().refresh();
 	}
 }
 
@@ -79,21 +142,23 @@ int main(int argc, char* args[])
 	sxi::renderer::addModel(MODELS_PATH + "Coffee_Table.obj");
 	sxi::renderer::addModel(MODELS_PATH + "Rocking_Chair.obj");
 
+	sxi::ecs::EntityHandle<Object> table;
 	{
 		sxi::ecs::EntityIndex<Object> ent = mgr.createEntity<Object>();
 		sxi::ecs::RenderComponent& render = mgr.component<sxi::ecs::RenderComponent>(ent);
 		render.mdl = 0;
 		render.tex = 0;
-		sxi::ecs::PositionComponent& pos = mgr.component<sxi::ecs::PositionComponent>(ent);
-		pos.pos = glm::vec3(20, 0, 20);
+		mgr.component<sxi::ecs::PositionComponent>(ent) = sxi::ecs::PositionComponent{ glm::vec3(20, 0, 20) };
+		table = mgr.createHandle(ent);
 	}
 	{
+		// the chair sits next to the table and turns with it
 		sxi::ecs::EntityIndex<Object> ent = mgr.createEntity<Object>();
 		sxi::ecs::RenderComponent& render = mgr.component<sxi::ecs::RenderComponent>(ent);
 		render.mdl = 1;
 		render.tex = 1;
-		sxi::ecs::PositionComponent& pos = mgr.component<sxi::ecs::PositionComponent>(ent);
-		pos.pos = glm::vec3(-20, 0, 20);
+		mgr.component<sxi::ecs::PositionComponent>(ent) = sxi::ecs::PositionComponent{ glm::vec3(-40, 0, 0) };
+		mgr.component<sxi::ecs::HierarchyComponent>(ent).parent = table;
 	}
 	mgr.createEntity<Light>();
 	mgr.refresh();
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stddef.h>
+
+#include "SXICore/ECS/Settings.h"
+
+// component of Bytes bytes, so storage can be measured against element size
+template <size_t Bytes>
+struct Payload
+{
+    static_assert(Bytes % sizeof(float) == 0, "Bytes must be a multiple of 4");
+
+    float value[Bytes / sizeof(float)];
+};
+
+using SmallComponent = Payload<4>;
+using MediumComponent = Payload<16>;
+using LargeComponent = Payload<64>;
+
+using Components = sxi::ecs::ComponentList<
+    SmallComponent,
+    MediumComponent,
+    LargeComponent>;
+
+struct VectorTag{};
+struct ChunkedTag{};
+using Tags = sxi::ecs::TagList<VectorTag, ChunkedTag>;
+
+// every component size once per storage backend
+template <typename TComponent>
+using VectorArchetype = sxi::ecs::Archetype<TComponent, VectorTag>;
+template <typename TComponent>
+using ChunkedArchetype = sxi::ecs::Archetype<TComponent, ChunkedTag>;
+
+using ChunkedArchetypes = sxi::ecs::ArchetypeList<
+    ChunkedArchetype<SmallComponent>,
+    ChunkedArchetype<MediumComponent>,
+    ChunkedArchetype<LargeComponent>>;
+using Archetypes = sxi::ecs::ArchetypeList<
+    VectorArchetype<SmallComponent>,
+    VectorArchetype<MediumComponent>,
+    VectorArchetype<LargeComponent>,
+    ChunkedArchetype<SmallComponent>,
+    ChunkedArchetype<MediumComponent>,
+    ChunkedArchetype<LargeComponent>>;
+
+// an archetype's own components, so iteration only visits that archetype
+template <typename TArchetype>
+struct SignatureOf;
+
+template <typename TComponent, typename TStorageTag>
+struct SignatureOf<sxi::ecs::Archetype<TComponent, TStorageTag>>
+{
+    using type = sxi::ecs::Signature<TComponent, TStorageTag>;
+};
+
+using Signatures = sxi::ecs::SignatureList<
+    typename SignatureOf<VectorArchetype<SmallComponent>>::type,
+    typename SignatureOf<VectorArchetype<MediumComponent>>::type,
+    typename SignatureOf<VectorArchetype<LargeComponent>>::type,
+    typename SignatureOf<ChunkedArchetype<SmallComponent>>::type,
+    typename SignatureOf<ChunkedArchetype<MediumComponent>>::type,
+    typename SignatureOf<ChunkedArchetype<LargeComponent>>::type>;
+
+struct BenchSettings final : sxi::ecs::Settings<
+    Components,
+    Tags,
+    Archetypes,
+    Signatures,
+    ChunkedArchetypes> {};
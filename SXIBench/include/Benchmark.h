@@ -0,0 +1,103 @@
+#pragma once
+
+#include <stddef.h>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace sxi::bench
+{
+	struct Options
+	{
+		size_t minEntities = 1000;
+		size_t maxEntities = 10000000;
+		// each case repeats until it ran for minSeconds, at least minRepetitions times
+		double minSeconds = 0.25;
+		size_t minRepetitions = 3;
+		size_t maxRepetitions = 100;
+		// only cases whose name contains filter run
+		std::string filter{};
+		std::string outputPath = "SXIBench.json";
+	};
+
+	/**
+	 * @brief Parses --min-entities, --max-entities, --min-time, --repetitions,
+	 * --filter and --out. Throws InvalidArgumentException on anything else.
+	 */
+	Options parseOptions(int, char**);
+
+	struct Case
+	{
+		std::string name;
+		std::string archetype;
+		std::string storage;
+		size_t componentBytes;
+		size_t entities;
+		double killRate;
+	};
+
+	struct Result
+	{
+		Case benchCase;
+		size_t repetitions;
+		double minSeconds;
+		double medianSeconds;
+		double meanSeconds;
+	};
+
+	/**
+	 * @brief Runs cases and collects their results.
+	 *
+	 * A case is a function performing one repetition: it prepares whatever it
+	 * needs untimed and returns the seconds its measured part took, usually
+	 * through a Stopwatch.
+	 */
+	class Runner
+	{
+	public:
+		explicit Runner(const Options&);
+
+		void run(const Case&, const std::function<double()>&);
+
+		/**
+		 * @brief Writes every result as JSON, one object per case, to the
+		 * output path so runs can be compared against a baseline.
+		 */
+		void write() const;
+
+		inline const Options& options() const noexcept { return opts; }
+
+	private:
+		Options opts;
+		std::vector<Result> results{};
+	};
+
+	class Stopwatch
+	{
+	public:
+		inline void start() noexcept { begin = std::chrono::steady_clock::now(); }
+
+		inline double stop() const noexcept
+		{
+			return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+		}
+
+	private:
+		std::chrono::steady_clock::time_point begin{};
+	};
+
+	/**
+	 * @brief Keeps the compiler from optimising away the computation of value.
+	 */
+	template <typename T>
+	inline void doNotOptimize(const T& value) noexcept
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		static volatile const T* sink;
+		sink = &value;
+#endif
+	}
+}
@@ -0,0 +1,124 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <string_view>
+#include <thread>
+
+#include "SXICore/Exception.h"
+
+namespace sxi::bench
+{
+	namespace
+	{
+		template <typename Parse>
+		auto parseValue(std::string_view flag, const char* value, Parse&& parse)
+		{
+			try
+			{
+				return parse(std::string(value));
+			}
+			catch (const std::exception&)
+			{
+				throw InvalidArgumentException("Invalid value for " + std::string(flag));
+			}
+		}
+
+		size_t parseCount(std::string_view flag, const char* value)
+		{
+			return parseValue(flag, value, [](const std::string& str){ return static_cast<size_t>(std::stoull(str)); });
+		}
+	}
+
+	Options parseOptions(int argc, char** argv)
+	{
+		Options options;
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string_view flag = argv[i];
+			if (i + 1 >= argc)
+				throw InvalidArgumentException("Missing value for " + std::string(flag));
+
+			const char* value = argv[++i];
+			if (flag == "--min-entities")
+				options.minEntities = parseCount(flag, value);
+			else if (flag == "--max-entities")
+				options.maxEntities = parseCount(flag, value);
+			else if (flag == "--min-time")
+				options.minSeconds = parseValue(flag, value, [](const std::string& str){ return std::stod(str); });
+			else if (flag == "--repetitions")
+				options.minRepetitions = std::max<size_t>(1, parseCount(flag, value));
+			else if (flag == "--filter")
+				options.filter = value;
+			else if (flag == "--out")
+				options.outputPath = value;
+			else
+				throw InvalidArgumentException("Unknown option " + std::string(flag));
+		}
+		return options;
+	}
+
+	Runner::Runner(const Options& options) : opts(options) {}
+
+	void Runner::run(const Case& benchCase, const std::function<double()>& repetition)
+	{
+		if (benchCase.name.find(opts.filter) == std::string::npos)
+			return;
+
+		std::vector<double> samples;
+		double total = 0;
+		while (samples.size() < opts.maxRepetitions && (samples.size() < opts.minRepetitions || total < opts.minSeconds))
+		{
+			samples.push_back(repetition());
+			total += samples.back();
+		}
+
+		std::sort(samples.begin(), samples.end());
+		Result result{ benchCase, samples.size(), samples.front(), samples[samples.size() / 2], total / samples.size() };
+		results.push_back(result);
+
+		std::printf("%-24s %-8s %-8s %4zuB %9zu kill %.2f  median %12.3f us  %8.2f ns/entity\n",
+			benchCase.name.c_str(), benchCase.archetype.c_str(), benchCase.storage.c_str(), benchCase.componentBytes,
+			benchCase.entities, benchCase.killRate, result.medianSeconds * 1e6, result.medianSeconds * 1e9 / benchCase.entities);
+		std::fflush(stdout);
+	}
+
+	void Runner::write() const
+	{
+		std::ofstream file(opts.outputPath, std::ios::trunc);
+		if (!file.is_open())
+			throw InvalidArgumentException("Failed to open benchmark output file");
+
+#ifdef NDEBUG
+		const char* buildType = "release";
+#else
+		const char* buildType = "debug";
+#endif
+		file.precision(9);
+		file << "{\n\"build\":\"" << buildType << "\",\n\"hardwareThreads\":" << std::thread::hardware_concurrency() << ",\n\"results\":[";
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const Result& result = results[i];
+			const Case& c = result.benchCase;
+			file << (i == 0 ? "\n" : ",\n")
+				<< "{\"name\":\"" << c.name
+				<< "\",\"archetype\":\"" << c.archetype
+				<< "\",\"storage\":\"" << c.storage
+				<< "\",\"componentBytes\":" << c.componentBytes
+				<< ",\"entities\":" << c.entities
+				<< ",\"killRate\":" << c.killRate
+				<< ",\"repetitions\":" << result.repetitions
+				<< ",\"minSeconds\":" << result.minSeconds
+				<< ",\"medianSeconds\":" << result.medianSeconds
+				<< ",\"meanSeconds\":" << result.meanSeconds
+				<< ",\"nsPerEntity\":" << result.medianSeconds * 1e9 / c.entities << "}";
+		}
+		file << "\n]\n}\n";
+
+		file.flush();
+		if (!file)
+			throw ResourceCreationException("Failed to write benchmark output file");
+	}
+}
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "SXICore/ECS/Manager.h"
+#include "BenchSettings.h"
+#include "Benchmark.h"
+
+using Manager = sxi::ecs::Manager<BenchSettings>;
+
+static constexpr size_t ENTITY_COUNTS[] = { 1000, 10000, 100000, 1000000, 10000000 };
+static constexpr double KILL_RATES[] = { 0.01, 0.1, 0.5, 0.9 };
+
+// managers are large, keep them off the stack
+template <typename TArchetype>
+static std::unique_ptr<Manager> populate(size_t count)
+{
+	std::unique_ptr<Manager> mgr = std::make_unique<Manager>();
+	(void)mgr->createEntities<TArchetype>(count);
+	mgr->refresh();
+	return mgr;
+}
+
+// the first count indices of a fixed random permutation of [0, entities)
+static std::vector<size_t> killOrder(size_t entities, size_t count)
+{
+	std::vector<size_t> order(entities);
+	std::iota(order.begin(), order.end(), size_t{0});
+	std::shuffle(order.begin(), order.end(), std::mt19937_64(42));
+	order.resize(count);
+	return order;
+}
+
+template <typename TArchetype, typename TComponent>
+static void benchArchetype(sxi::bench::Runner& runner, const char* archetype, const char* storage, size_t entities)
+{
+	using Signature = typename SignatureOf<TArchetype>::type;
+	using Index = sxi::ecs::EntityIndex<TArchetype>;
+	auto benchCase = [&](const char* name, double killRate=0.0){
+		return sxi::bench::Case{ name, archetype, storage, sizeof(TComponent), entities, killRate };
+	};
+
+	runner.run(benchCase("create"), [entities](){
+		std::unique_ptr<Manager> mgr = std::make_unique<Manager>();
+		sxi::bench::Stopwatch stopwatch;
+		stopwatch.start();
+		for (size_t i = 0; i < entities; ++i)
+			(void)mgr->createEntity<TArchetype>();
+		mgr->refresh();
+		return stopwatch.stop();
+	});
+
+	runner.run(benchCase("createBulk"), [entities](){
+		std::unique_ptr<Manager> mgr = std::make_unique<Manager>();
+		sxi::bench::Stopwatch stopwatch;
+		stopwatch.start();
+		(void)mgr->createEntities<TArchetype>(entities);
+		mgr->refresh();
+		return stopwatch.stop();
+	});
+
+	{
+		std::unique_ptr<Manager> mgr = populate<TArchetype>(entities);
+
+		runner.run(benchCase("componentByIndex"), [&mgr, entities](){
+			sxi::bench::Stopwatch stopwatch;
+			stopwatch.start();
+			for (size_t i = 0; i < entities; ++i)
+				mgr->component<TComponent>(Index{i}).value[0] += 1.f;
+			return stopwatch.stop();
+		});
+
+		std::vector<sxi::ecs::EntityHandle<TArchetype>> handles;
+		handles.reserve(entities);
+		for (size_t i = 0; i < entities; ++i)
+			handles.push_back(mgr->createHandle(Index{i}));
+
+		runner.run(benchCase("componentByHandle"), [&mgr, &handles](){
+			sxi::bench::Stopwatch stopwatch;
+			stopwatch.start();
+			for (const sxi::ecs::EntityHandle<TArchetype>& handle : handles)
+				mgr->component<TComponent>(handle).value[0] += 1.f;
+			return stopwatch.stop();
+		});
+
+		runner.run(benchCase("forEntitiesMatching"), [&mgr](){
+			sxi::bench::Stopwatch stopwatch;
+			stopwatch.start();
+			mgr->forEntitiesMatching<Signature>([](auto, TComponent& component){
+				component.value[0] += 1.f;
+			});
+			return stopwatch.stop();
+		});
+
+		float sum = 0.f;
+		std::as_const(*mgr).forEntitiesMatching<Signature>([&sum](auto, const TComponent& component){
+			sum += component.value[0];
+		});
+		sxi::bench::doNotOptimize(sum);
+	}
+
+	for (double killRate : KILL_RATES)
+	{
+		std::vector<size_t> order = killOrder(entities, static_cast<size_t>(entities * killRate));
+
+		runner.run(benchCase("kill", killRate), [entities, &order](){
+			std::unique_ptr<Manager> mgr = populate<TArchetype>(entities);
+			sxi::bench::Stopwatch stopwatch;
+			stopwatch.start();
+			for (size_t i : order)
+				mgr->kill(Index{i});
+			return stopwatch.stop();
+		});
+
+		runner.run(benchCase("refresh", killRate), [entities, &order](){
+			std::unique_ptr<Manager> mgr = populate<TArchetype>(entities);
+			for (size_t i : order)
+				mgr->kill(Index{i});
+			sxi::bench::Stopwatch stopwatch;
+			stopwatch.start();
+			mgr->refresh();
+			return stopwatch.stop();
+		});
+	}
+}
+
+template <typename TComponent>
+static void benchComponent(sxi::bench::Runner& runner, const char* name, size_t entities)
+{
+	benchArchetype<VectorArchetype<TComponent>, TComponent>(runner, name, "vector", entities);
+	benchArchetype<ChunkedArchetype<TComponent>, TComponent>(runner, name, "chunked", entities);
+}
+
+int main(int argc, char* argv[])
+{
+	try
+	{
+		sxi::bench::Runner runner(sxi::bench::parseOptions(argc, argv));
+		for (size_t entities : ENTITY_COUNTS)
+		{
+			if (entities < runner.options().minEntities || entities > runner.options().maxEntities)
+				continue;
+
+			benchComponent<SmallComponent>(runner, "small", entities);
+			benchComponent<MediumComponent>(runner, "medium", entities);
+			benchComponent<LargeComponent>(runner, "large", entities);
+		}
+		runner.write();
+	}
+	catch (const std::exception& e)
+	{
+		std::fprintf(stderr, "%s\n", e.what());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,127 @@
+// Synthetic worst case for the compile-time ECS: 500 components, 100
+// archetypes and 100 signatures. Only compiled by the SXICompileStress target,
+// which reports how long it takes and how much memory the compiler needs.
+
+#include <stddef.h>
+#include <memory>
+#include <utility>
+
+#include "SXICore/ECS/Manager.h"
+#include "SXICore/ECS/Settings.h"
+#include "SXICore/MPL/Count.h"
+#include "SXICore/MPL/Filter.h"
+#include "SXICore/Types.h"
+
+namespace stress
+{
+    inline constexpr size_t COMPONENT_COUNT = 500;
+    inline constexpr size_t ARCHETYPE_COUNT = 100;
+    inline constexpr size_t SIGNATURE_COUNT = 100;
+    inline constexpr size_t COMPONENTS_PER_ARCHETYPE = 8;
+    inline constexpr size_t COMPONENTS_PER_SIGNATURE = 3;
+
+    template <size_t I>
+    struct Component
+    {
+        sxi::u32 value;
+    };
+
+    // keeps archetypes with the same components apart
+    template <size_t I>
+    struct Tag {};
+
+    // K-th component of archetype A, distinct for every K < 8
+    template <size_t A, size_t K>
+    using ComponentOf = Component<(A * 7 + K * 61) % COMPONENT_COUNT>;
+
+    template <size_t A, typename TIndices>
+    struct ArchetypeAt;
+
+    template <size_t A, size_t... Ks>
+    struct ArchetypeAt<A, std::index_sequence<Ks...>>
+    {
+        using type = sxi::ecs::Archetype<ComponentOf<A, Ks>..., Tag<A>>;
+    };
+
+    template <size_t A>
+    using Archetype = typename ArchetypeAt<A, std::make_index_sequence<COMPONENTS_PER_ARCHETYPE>>::type;
+
+    // signature S matches archetype S and every other archetype sharing its components
+    template <size_t S, typename TIndices>
+    struct SignatureAt;
+
+    template <size_t S, size_t... Ks>
+    struct SignatureAt<S, std::index_sequence<Ks...>>
+    {
+        using type = sxi::ecs::Signature<ComponentOf<S % ARCHETYPE_COUNT, Ks>...>;
+    };
+
+    template <size_t S>
+    using Signature = typename SignatureAt<S, std::make_index_sequence<COMPONENTS_PER_SIGNATURE>>::type;
+
+    template <typename TIndices>
+    struct Lists;
+
+    template <size_t... Is>
+    struct Lists<std::index_sequence<Is...>>
+    {
+        using Components = sxi::ecs::ComponentList<Component<Is>...>;
+        using Tags = sxi::ecs::TagList<Tag<Is>...>;
+    };
+
+    template <typename TIndices>
+    struct ArchetypeLists;
+
+    template <size_t... As>
+    struct ArchetypeLists<std::index_sequence<As...>>
+    {
+        using Archetypes = sxi::ecs::ArchetypeList<Archetype<As>...>;
+        using Chunked = sxi::ecs::ArchetypeList<Archetype<As * 2>...>;
+    };
+
+    template <typename TIndices>
+    struct SignatureLists;
+
+    template <size_t... Ss>
+    struct SignatureLists<std::index_sequence<Ss...>>
+    {
+        using Signatures = sxi::ecs::SignatureList<Signature<Ss>...>;
+    };
+
+    // a named type keeps the lists out of every type spelled in terms of the settings
+    struct Settings final : sxi::ecs::Settings<
+        typename Lists<std::make_index_sequence<COMPONENT_COUNT>>::Components,
+        typename Lists<std::make_index_sequence<ARCHETYPE_COUNT>>::Tags,
+        typename ArchetypeLists<std::make_index_sequence<ARCHETYPE_COUNT>>::Archetypes,
+        typename SignatureLists<std::make_index_sequence<SIGNATURE_COUNT>>::Signatures,
+        typename ArchetypeLists<std::make_index_sequence<ARCHETYPE_COUNT / 2>>::Chunked> {};
+
+    // one list operation over all 500 components, more than clang takes in a single fold
+    static_assert(sxi::mpl::Count<sxi::mpl::Filter<Settings::IsComponentFilter, Settings::ComponentList>>::value == COMPONENT_COUNT);
+
+    using Manager = sxi::ecs::Manager<Settings>;
+
+    template <size_t... As>
+    void createEntities(Manager& mgr, std::index_sequence<As...>)
+    {
+        ((void)mgr.createEntity<Archetype<As>>(), ...);
+    }
+
+    template <size_t... Ss>
+    size_t visitSignatures(Manager& mgr, std::index_sequence<Ss...>)
+    {
+        size_t visited = 0;
+        (mgr.forEntitiesMatching<Signature<Ss>>([&visited](auto, auto&...){
+            ++visited;
+        }), ...);
+        return visited;
+    }
+}
+
+int main()
+{
+    std::unique_ptr<stress::Manager> mgr = std::make_unique<stress::Manager>();
+    stress::createEntities(*mgr, std::make_index_sequence<stress::ARCHETYPE_COUNT>{});
+    mgr->refresh();
+    return stress::visitSignatures(*mgr, std::make_index_sequence<stress::SIGNATURE_COUNT>{}) > 0 ? 0 : 1;
+}
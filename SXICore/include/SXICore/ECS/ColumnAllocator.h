@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace sxi::ecs
+{
+    /**
+     * @brief Allocation policy for component columns, passed to Settings.
+     *
+     * @tparam TAlignment: Alignment of every column, one cache line by default.
+     * @tparam TPaddingBytes: Zeroed bytes kept readable after the last element of a
+     *                        column, so SIMD kernels may load whole vectors past the tail.
+     * @tparam THugePages: Back columns of at least hugePageBytes with anonymous mmap and
+     *                     ask for transparent huge pages. Linux only, ignored elsewhere.
+     */
+    template <size_t TAlignment = 64, size_t TPaddingBytes = 0, bool THugePages = false>
+    struct ColumnAllocator
+    {
+        static_assert(TAlignment != 0 && (TAlignment & (TAlignment - 1)) == 0, "TAlignment must be a power of two");
+        static constexpr size_t alignment = TAlignment;
+        static constexpr size_t paddingBytes = TPaddingBytes;
+        static constexpr size_t hugePageBytes = 2 * 1024 * 1024;
+
+        static_assert(!THugePages || TAlignment <= hugePageBytes, "Huge page columns are only aligned to hugePageBytes");
+
+#if defined(__linux__)
+        static constexpr bool hugePages = THugePages;
+#else
+        static constexpr bool hugePages = false;
+#endif
+
+        [[nodiscard]] static constexpr bool usesHugePages(size_t bytes) noexcept
+        {
+            return hugePages && bytes >= hugePageBytes;
+        }
+
+        /**
+         * @brief Bytes actually allocated for a column holding bytes of elements,
+         * padding included. Pass the result to allocate and deallocate.
+         */
+        [[nodiscard]] static constexpr size_t allocationBytes(size_t bytes) noexcept
+        {
+            size_t granularity = usesHugePages(bytes + paddingBytes) ? hugePageBytes : alignment;
+            return (bytes + paddingBytes + granularity - 1) / granularity * granularity;
+        }
+
+        [[nodiscard]] static void* allocate(size_t bytes)
+        {
+#if defined(__linux__)
+            if (usesHugePages(bytes))
+            {
+                // mmap only aligns to regular pages, and a column that does not start on
+                // a huge page boundary keeps regular pages at both ends. Mapping one huge
+                // page more and unmapping the slack around the aligned start leaves a
+                // mapping of exactly bytes, which deallocate can unmap as is.
+                size_t mappedBytes = bytes + hugePageBytes;
+                void* mapped = mmap(nullptr, mappedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (mapped == MAP_FAILED)
+                    throw std::bad_alloc();
+
+                uintptr_t begin = reinterpret_cast<uintptr_t>(mapped);
+                uintptr_t aligned = (begin + hugePageBytes - 1) / hugePageBytes * hugePageBytes;
+                if (aligned > begin)
+                    munmap(mapped, aligned - begin);
+                if (aligned + bytes < begin + mappedBytes)
+                    munmap(reinterpret_cast<void*>(aligned + bytes), begin + mappedBytes - aligned - bytes);
+
+                void* memory = reinterpret_cast<void*>(aligned);
+                // only a hint, kernels without THP simply keep regular pages
+                madvise(memory, bytes, MADV_HUGEPAGE);
+                return memory;
+            }
+#endif
+            return ::operator new(bytes, std::align_val_t{alignment});
+        }
+
+        static void deallocate(void* memory, size_t bytes) noexcept
+        {
+#if defined(__linux__)
+            if (usesHugePages(bytes))
+            {
+                munmap(memory, bytes);
+                return;
+            }
+#endif
+            ::operator delete(memory, std::align_val_t{alignment});
+        }
+    };
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <stddef.h>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "Entity.h"
+
+#include "../MPL/Filter.h"
+#include "../MPL/Rename.h"
+#include "../MPL/Tuple.h"
+#include "../MPL/TypeListOperations.h"
+
+namespace sxi::ecs
+{
+    template <typename TArchetype>
+    SXI_MPL_STRONG_TYPEDEF(size_t, PendingEntity);
+
+    namespace detail
+    {
+        template <typename TSettings, typename TArchetype>
+        struct ArchetypeCommands final
+        {
+            using Components = mpl::Tuple<mpl::Filter<TSettings::template IsComponentFilter, TArchetype>>;
+
+            std::vector<Components> creates;
+            std::vector<EntityIndex<TArchetype>> kills;
+            std::vector<EntityHandle<TArchetype>> handleKills;
+            std::vector<std::pair<EntityIndex<TArchetype>, bool>> enables;
+
+            [[nodiscard]] bool empty() const noexcept
+            {
+                return creates.empty() && kills.empty() && handleKills.empty() && enables.empty();
+            }
+
+            void clear() noexcept
+            {
+                enables.clear();
+                creates.clear();
+                kills.clear();
+                handleKills.clear();
+            }
+        };
+    }
+
+    /**
+     * @brief Records structural changes to be applied by Manager::refresh.
+     *
+     * The Manager owns one buffer per job system worker plus one for threads
+     * outside the pool, so systems running in parallel can record into
+     * Manager::commandBuffer without synchronisation. Enable changes are applied
+     * first, then kills, then creations, and everything becomes visible after the
+     * refresh that applies it.
+     */
+    template <typename TSettings>
+    class CommandBuffer final
+    {
+        template <typename... Ts>
+        using TupleOfCommands = std::tuple<detail::ArchetypeCommands<TSettings, Ts>...>;
+        mpl::Rename<TupleOfCommands, typename TSettings::ArchetypeList> commands;
+
+    public:
+        template <typename TArchetype>
+        [[nodiscard]] detail::ArchetypeCommands<TSettings, TArchetype>& archetypeCommands() noexcept
+        {
+            return std::get<detail::ArchetypeCommands<TSettings, TArchetype>>(commands);
+        }
+
+        /**
+         * @brief Queues the creation of an entity with default initialised components.
+         *
+         * Use component on the returned PendingEntity to initialise them. References
+         * returned by component stay valid until the next createEntity on this buffer.
+         */
+        template <typename TArchetype>
+        [[nodiscard]] PendingEntity<TArchetype> createEntity()
+        {
+            static_assert(TSettings::template isArchetype<TArchetype>(), "TArchetype must be an archetype");
+
+            auto& creates = archetypeCommands<TArchetype>().creates;
+            creates.emplace_back();
+            return PendingEntity<TArchetype>{creates.size() - 1};
+        }
+
+        template <typename TComponent, typename TArchetype>
+        [[nodiscard]] TComponent& component(PendingEntity<TArchetype> entity) noexcept
+        {
+            static_assert(TSettings::template isComponent<TComponent>(), "TComponent must be a component");
+
+            return std::get<TComponent>(archetypeCommands<TArchetype>().creates[entity]);
+        }
+
+        template <typename TArchetype>
+        void kill(EntityIndex<TArchetype> index)
+        {
+            archetypeCommands<TArchetype>().kills.push_back(index);
+        }
+
+        template <typename TArchetype>
+        void kill(const EntityHandle<TArchetype>& handle)
+        {
+            archetypeCommands<TArchetype>().handleKills.push_back(handle);
+        }
+
+        template <typename TArchetype>
+        void setEnabled(EntityIndex<TArchetype> index, bool enabled)
+        {
+            archetypeCommands<TArchetype>().enables.emplace_back(index, enabled);
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            bool result = true;
+            mpl::forTuple([&result](const auto& c){
+                result = result && c.empty();
+            }, commands);
+            return result;
+        }
+    };
+}
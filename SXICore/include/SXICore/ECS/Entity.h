@@ -1,5 +1,8 @@
 #pragma once
 
+#include <stddef.h>
+#include <limits>
+
 #include "../MPL/Macros.h"
 
 namespace sxi::ecs
@@ -26,20 +29,91 @@ namespace sxi::ecs
         class EntityHandleData final
         {
             EntityIndex<TArchetype> index;
-            int counter;
+            unsigned int counter;
+            // row of the world's handle aliases once the entity migrated, shared by
+            // the slots it holds in every archetype it went through
+            size_t alias = std::numeric_limits<size_t>::max();
 
             template <typename T, typename U>
             friend class ArchetypeStorage;
         };
     }
 
+    /**
+     * @brief Contiguous run of entity indices [first, last), as returned by bulk creation.
+     */
+    template <typename TArchetype>
+    struct EntityRange final
+    {
+        class Iterator final
+        {
+            size_t index;
+
+        public:
+            explicit Iterator(size_t index) noexcept : index(index) {}
+
+            EntityIndex<TArchetype> operator*() const noexcept { return EntityIndex<TArchetype>{index}; }
+            Iterator& operator++() noexcept { ++index; return *this; }
+            bool operator==(const Iterator& other) const noexcept { return index == other.index; }
+            bool operator!=(const Iterator& other) const noexcept { return index != other.index; }
+        };
+
+        size_t first{};
+        size_t last{};
+
+        [[nodiscard]] size_t size() const noexcept { return last - first; }
+        [[nodiscard]] EntityIndex<TArchetype> operator[](size_t i) const noexcept { return EntityIndex<TArchetype>{first + i}; }
+
+        [[nodiscard]] Iterator begin() const noexcept { return Iterator{first}; }
+        [[nodiscard]] Iterator end() const noexcept { return Iterator{last}; }
+    };
+
+    /**
+     * @brief EntityHandle with its archetype erased, empty when default constructed.
+     *
+     * Lets a component refer to entities of the archetype it is part of, which it
+     * cannot name. Only convert it back to the archetype it was created from.
+     */
+    class AnyEntityHandle final
+    {
+        size_t handleDataIndex = std::numeric_limits<size_t>::max();
+        unsigned int counter{};
+
+        template <typename TArchetype>
+        friend class EntityHandle;
+
+    public:
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return handleDataIndex == std::numeric_limits<size_t>::max();
+        }
+
+        bool operator==(const AnyEntityHandle&) const noexcept = default;
+    };
+
     template <typename TArchetype>
     class EntityHandle final
     {
         detail::EntityHandleDataIndex<TArchetype> handleDataIndex;
-        int counter;
+        unsigned int counter;
 
             template <typename T, typename U>
             friend class detail::ArchetypeStorage;
+
+    public:
+        EntityHandle() = default;
+
+        explicit EntityHandle(const AnyEntityHandle& handle) noexcept
+            : handleDataIndex(handle.handleDataIndex), counter(handle.counter)
+        {
+        }
+
+        operator AnyEntityHandle() const noexcept
+        {
+            AnyEntityHandle handle;
+            handle.handleDataIndex = handleDataIndex;
+            handle.counter = counter;
+            return handle;
+        }
     };
 }
\ No newline at end of file
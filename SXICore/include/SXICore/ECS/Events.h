@@ -0,0 +1,216 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <assert.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace sxi::ecs
+{
+    namespace detail
+    {
+        /**
+         * @brief Bump allocator whose memory lives until the next reset.
+         *
+         * Allocation is lock-free. When the current block is full a new one is
+         * pushed with a compare-and-swap, and reset folds every block of the frame
+         * into a single one, so a steady workload stops allocating after its first
+         * frames.
+         */
+        class FrameArena final
+        {
+            struct Block
+            {
+                Block* next;
+                size_t capacity;
+                std::atomic<size_t> used{0};
+                std::unique_ptr<std::byte[]> data;
+
+                Block(Block* next, size_t capacity) : next(next), capacity(capacity), data(new std::byte[capacity]) {}
+            };
+
+            std::atomic<Block*> current{nullptr};
+            size_t blockSize;
+
+            void destroyBlocks() noexcept
+            {
+                Block* block = current.load(std::memory_order_relaxed);
+                while (block)
+                {
+                    Block* next = block->next;
+                    delete block;
+                    block = next;
+                }
+                current.store(nullptr, std::memory_order_relaxed);
+            }
+
+        public:
+            explicit FrameArena(size_t blockSize = 64 * 1024) : blockSize(blockSize) {}
+            FrameArena(const FrameArena&) = delete;
+            FrameArena& operator=(const FrameArena&) = delete;
+            ~FrameArena() { destroyBlocks(); }
+
+            [[nodiscard]] void* allocate(size_t bytes, size_t alignment)
+            {
+                const size_t padded = bytes + alignment - 1;
+                Block* block = current.load(std::memory_order_acquire);
+                for (;;)
+                {
+                    if (block)
+                    {
+                        size_t offset = block->used.fetch_add(padded, std::memory_order_relaxed);
+                        if (offset + padded <= block->capacity)
+                        {
+                            uintptr_t address = reinterpret_cast<uintptr_t>(block->data.get() + offset);
+                            return reinterpret_cast<void*>((address + alignment - 1) & ~(alignment - 1));
+                        }
+                    }
+
+                    // on failure block is reloaded with the winner's block and retried
+                    Block* fresh = new Block(block, std::max(blockSize, padded));
+                    if (current.compare_exchange_strong(block, fresh, std::memory_order_acq_rel))
+                        block = fresh;
+                    else
+                        delete fresh;
+                }
+            }
+
+            /**
+             * @brief Frees everything allocated since the last reset. Not thread-safe.
+             */
+            void reset()
+            {
+                Block* block = current.load(std::memory_order_relaxed);
+                if (!block)
+                    return;
+
+                if (!block->next)
+                {
+                    block->used.store(0, std::memory_order_relaxed);
+                    return;
+                }
+
+                size_t capacity = 0;
+                for (Block* b = block; b; b = b->next)
+                    capacity += b->capacity;
+                destroyBlocks();
+                current.store(new Block(nullptr, capacity), std::memory_order_relaxed);
+            }
+        };
+    }
+
+    /**
+     * @brief Events of one type emitted since the last refresh, stored in pages
+     * taken from the world's frame arena.
+     *
+     * Page p holds twice as many events as page p - 1, so a slot maps to its page
+     * with a bit scan and pages never move once published.
+     */
+    template <typename TEvent>
+    class EventChannel final
+    {
+        static_assert(std::is_trivially_copyable_v<TEvent> && std::is_trivially_destructible_v<TEvent>,
+            "Events live in a frame arena that never runs destructors");
+
+        static constexpr size_t FIRST_PAGE_BITS = 6;
+        static constexpr size_t PAGE_COUNT = sizeof(size_t) * 8 - FIRST_PAGE_BITS;
+
+        std::atomic<size_t> count{0};
+        std::array<std::atomic<TEvent*>, PAGE_COUNT> pages{};
+
+        static size_t pageOf(size_t slot) noexcept
+        {
+            return std::bit_width((slot >> FIRST_PAGE_BITS) + 1) - 1;
+        }
+
+        static size_t pageStart(size_t page) noexcept
+        {
+            return ((size_t(1) << page) - 1) << FIRST_PAGE_BITS;
+        }
+
+        static size_t pageCapacity(size_t page) noexcept
+        {
+            return size_t(1) << (page + FIRST_PAGE_BITS);
+        }
+
+    public:
+        /**
+         * @brief Lock-free append. Concurrent emitters racing for a new page both
+         * allocate one, the loser's stays unused until the arena is reset.
+         */
+        void emit(detail::FrameArena& arena, const TEvent& event)
+        {
+            size_t slot = count.fetch_add(1, std::memory_order_relaxed);
+            size_t page = pageOf(slot);
+
+            TEvent* events = pages[page].load(std::memory_order_acquire);
+            if (!events)
+            {
+                TEvent* fresh = static_cast<TEvent*>(arena.allocate(pageCapacity(page) * sizeof(TEvent), alignof(TEvent)));
+                if (pages[page].compare_exchange_strong(events, fresh, std::memory_order_acq_rel))
+                    events = fresh;
+            }
+            ::new (events + (slot - pageStart(page))) TEvent(event);
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return count.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] const TEvent& operator[](size_t slot) const noexcept
+        {
+            assert(slot < size());
+            size_t page = pageOf(slot);
+            return pages[page].load(std::memory_order_relaxed)[slot - pageStart(page)];
+        }
+
+        // the pages belong to the arena, which is reset right after
+        void clear() noexcept
+        {
+            count.store(0, std::memory_order_relaxed);
+            for (std::atomic<TEvent*>& page : pages)
+                page.store(nullptr, std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * @brief Read-only view of the events of one type emitted this frame.
+     */
+    template <typename TEvent>
+    class EventRange final
+    {
+        const EventChannel<TEvent>* channel;
+        size_t count;
+
+    public:
+        class Iterator final
+        {
+            const EventChannel<TEvent>* channel;
+            size_t slot;
+
+        public:
+            Iterator(const EventChannel<TEvent>* channel, size_t slot) noexcept : channel(channel), slot(slot) {}
+
+            const TEvent& operator*() const noexcept { return (*channel)[slot]; }
+            const TEvent* operator->() const noexcept { return &(*channel)[slot]; }
+            Iterator& operator++() noexcept { ++slot; return *this; }
+            bool operator==(const Iterator& other) const noexcept { return slot == other.slot; }
+        };
+
+        explicit EventRange(const EventChannel<TEvent>& channel) noexcept : channel(&channel), count(channel.size()) {}
+
+        [[nodiscard]] size_t size() const noexcept { return count; }
+        [[nodiscard]] bool empty() const noexcept { return count == 0; }
+        [[nodiscard]] const TEvent& operator[](size_t i) const noexcept { return (*channel)[i]; }
+
+        [[nodiscard]] Iterator begin() const noexcept { return Iterator{channel, 0}; }
+        [[nodiscard]] Iterator end() const noexcept { return Iterator{channel, count}; }
+    };
+}
@@ -2,11 +2,25 @@
 
 #include "Settings.h"
 #include "Entity.h"
+#include "CommandBuffer.h"
+#include "Events.h"
 #include "detail/ArchetypeStorage.h"
+#include "../Jobs/ThreadPool.h"
+#include <array>
 #include <iostream>
+#include <mutex>
+#include <tuple>
 
 #include "../MPL/TypeListOperations.h"
 #include "../MPL/IsSubset.h"
+#include "../MPL/Contains.h"
+#include "../MPL/IndexOf.h"
+#include "../MPL/Map.h"
+#include "../MPL/Tuple.h"
+#include "../Exception.h"
+#include "../File.h"
+#include "../Profiler.h"
+#include "../Types.h"
 
 namespace sxi::ecs
 {
@@ -32,7 +46,216 @@ namespace sxi::ecs
             return std::get<detail::ArchetypeStorage<TSettings, TArchetype>>(archetypes);
         }
 
+        // visits only the storages TSignature matches, so queries never instantiate
+        // anything for the rest of the archetypes
+        template <typename TSignature, typename Func>
+        void forStoragesMatching(Func&& func)
+        {
+            mpl::forTypes<MatchingArchetypes<TSettings, TSignature>>([this, &func](auto t){
+                func(archetypeStorage<SXI_MPL_TYPE(t)>());
+            });
+        }
+
+        template <typename TSignature, typename Func>
+        void forStoragesMatching(Func&& func) const
+        {
+            mpl::forTypes<MatchingArchetypes<TSettings, TSignature>>([this, &func](auto t){
+                func(archetypeStorage<SXI_MPL_TYPE(t)>());
+            });
+        }
+
+        // one per worker plus one for threads outside the pool, sized on first use
+        // so constructing a world, even a static one, does not start the pool
+        std::vector<CommandBuffer<TSettings>> commandBuffers;
+        std::once_flag commandBuffersSized;
+
+        u64 currentVersion = 1;
+
+        // distinct per migration, even for the ones leaving the same archetype
+        template <typename TMigration>
+        struct PendingMigrations final
+        {
+            std::vector<EntityIndex<typename TMigration::From>> sources;
+        };
+        mpl::Tuple<mpl::Map<PendingMigrations, typename TSettings::MigrationList>> migrations;
+
+        // one row per entity that migrated while it had a handle: the slot it holds
+        // in every archetype it went through, max() where it has none. Every slot
+        // of a row stores the row's index, so any of the entity's handles finds it
+        using HandleAliases = std::array<size_t, mpl::Count<ArchetypeList>::value>;
+        std::vector<HandleAliases> handleAliases;
+        std::vector<size_t> freeHandleAliases;
+
+        // world-global data, one default constructed instance per type
+        mpl::Tuple<typename TSettings::ResourceList> resources;
+
+        // events live until the next refresh, their pages come from the arena
+        detail::FrameArena eventArena;
+        mpl::Tuple<mpl::Map<EventChannel, typename TSettings::EventList>> eventChannels;
+
+        template <typename TFrom, typename TTo>
+        PendingMigrations<Migration<TFrom, TTo>>& pendingMigrations() noexcept
+        {
+            static_assert(Settings::template isMigration<TFrom, TTo>(), "Migration<TFrom, TTo> must be listed in the settings' MigrationList");
+
+            return std::get<PendingMigrations<Migration<TFrom, TTo>>>(migrations);
+        }
+
+        // TFrom's slot becomes part of an alias row, and the entity gets the row's TTo slot
+        template <typename TFrom, typename TTo>
+        detail::EntityHandleDataIndex<TTo> forwardHandle(detail::EntityHandleDataIndex<TFrom> fromSlot)
+        {
+            size_t alias = archetypeStorage<TFrom>().handleAlias(fromSlot);
+            if (alias == std::numeric_limits<size_t>::max())
+            {
+                if (freeHandleAliases.empty())
+                {
+                    alias = handleAliases.size();
+                    handleAliases.emplace_back();
+                }
+                else
+                {
+                    alias = freeHandleAliases.back();
+                    freeHandleAliases.pop_back();
+                }
+                handleAliases[alias].fill(std::numeric_limits<size_t>::max());
+                handleAliases[alias][mpl::IndexOf<TFrom, ArchetypeList>::value] = fromSlot;
+                archetypeStorage<TFrom>().setHandleAlias(fromSlot, alias);
+            }
+
+            // reusing the entity's old slot brings its old TTo handles back to life
+            size_t& toSlot = handleAliases[alias][mpl::IndexOf<TTo, ArchetypeList>::value];
+            if (toSlot == std::numeric_limits<size_t>::max())
+            {
+                toSlot = archetypeStorage<TTo>().reserveHandleSlot();
+                archetypeStorage<TTo>().setHandleAlias(detail::EntityHandleDataIndex<TTo>{toSlot}, alias);
+            }
+            return detail::EntityHandleDataIndex<TTo>{toSlot};
+        }
+
+        // an entity that died releases the slots it left behind in other archetypes
+        void releaseHandleAliases()
+        {
+            mpl::forTypes<ArchetypeList>([this](auto t){
+                std::vector<size_t>& released = archetypeStorage<SXI_MPL_TYPE(t)>().releasedHandleAliases();
+                for (size_t alias : released)
+                {
+                    mpl::forTypes<ArchetypeList>([this, alias](auto u){
+                        using TArchetype = SXI_MPL_TYPE(u);
+                        detail::EntityHandleDataIndex<TArchetype> slot{handleAliases[alias][mpl::IndexOf<TArchetype, ArchetypeList>::value]};
+                        // the slot the entity died with was freed by its storage already
+                        if (slot != std::numeric_limits<size_t>::max() && archetypeStorage<TArchetype>().handleAlias(slot) == alias)
+                            archetypeStorage<TArchetype>().releaseHandleSlot(slot);
+                    });
+                    freeHandleAliases.push_back(alias);
+                }
+                released.clear();
+            });
+        }
+
+        template <typename TArchetype>
+        void applyCommands(detail::ArchetypeStorage<TSettings, TArchetype>& as)
+        {
+            size_t createCount = 0;
+            for (CommandBuffer<TSettings>& cb : commandBuffers)
+            {
+                auto& commands = cb.template archetypeCommands<TArchetype>();
+                for (const auto& [index, enabled] : commands.enables)
+                    as.setEnabled(index, enabled);
+                for (EntityIndex<TArchetype> index : commands.kills)
+                    as.kill(index);
+                for (const EntityHandle<TArchetype>& handle : commands.handleKills)
+                    as.kill(handle);
+                createCount += commands.creates.size();
+            }
+
+            EntityRange<TArchetype> created = as.createEntities(createCount);
+            size_t next = created.first;
+
+            for (CommandBuffer<TSettings>& cb : commandBuffers)
+            {
+                auto& commands = cb.template archetypeCommands<TArchetype>();
+                for (auto& components : commands.creates)
+                {
+                    EntityIndex<TArchetype> index{next++};
+                    mpl::forTuple([&as, index](auto& c){
+                        as.template component<std::decay_t<decltype(c)>>(index) = std::move(c);
+                    }, components);
+                }
+                commands.clear();
+            }
+        }
+
     public:
+        Manager() = default;
+
+        /**
+         * @brief Command buffer owned by the calling thread.
+         *
+         * Safe to use from any job system worker concurrently with other workers.
+         * All threads outside the pool share a single buffer.
+         */
+        CommandBuffer<TSettings>& commandBuffer() noexcept
+        {
+            jobs::ThreadPool& pool = jobs::threadPool();
+            std::call_once(commandBuffersSized, [this, &pool](){
+                commandBuffers.resize(pool.workerCount() + 1);
+            });
+            return commandBuffers[pool.currentWorkerIndex()];
+        }
+
+        /**
+         * @brief The world's only instance of TResource, e.g. the camera or frame timing.
+         *
+         * Access is not synchronised. Systems list the resources they read in their
+         * ReadList and the ones they write in their WriteList, so the Scheduler never
+         * runs a writer alongside another system using the same resource. Resources
+         * are not part of snapshots.
+         */
+        template <typename TResource>
+        [[nodiscard]] TResource& resource() noexcept
+        {
+            static_assert(Settings::template isResource<TResource>(), "TResource must be listed in the settings' ResourceList");
+
+            return std::get<TResource>(resources);
+        }
+
+        template <typename TResource>
+        [[nodiscard]] const TResource& resource() const noexcept
+        {
+            static_assert(Settings::template isResource<TResource>(), "TResource must be listed in the settings' ResourceList");
+
+            return std::get<TResource>(resources);
+        }
+
+        /**
+         * @brief Appends an event that read<TEvent> returns until the next refresh.
+         *
+         * Lock-free, so jobs of a parallel query may emit concurrently. Systems list
+         * the events they emit in their WriteList and the ones they read in their
+         * ReadList, and the Scheduler requires readers to be listed after every
+         * emitter, so they see the whole frame's events before refresh drops them.
+         */
+        template <typename TEvent>
+        void emit(const TEvent& event)
+        {
+            static_assert(Settings::template isEvent<TEvent>(), "TEvent must be listed in the settings' EventList");
+
+            std::get<EventChannel<TEvent>>(eventChannels).emit(eventArena, event);
+        }
+
+        /**
+         * @brief Events of type TEvent emitted since the last refresh. Must not
+         * overlap with emitting the same type.
+         */
+        template <typename TEvent>
+        [[nodiscard]] EventRange<TEvent> read() const noexcept
+        {
+            static_assert(Settings::template isEvent<TEvent>(), "TEvent must be listed in the settings' EventList");
+
+            return EventRange<TEvent>(std::get<EventChannel<TEvent>>(eventChannels));
+        }
+
         template <typename TArchetype>
         EntityIndex<TArchetype> createEntity()
         {
@@ -41,8 +264,47 @@ namespace sxi::ecs
             return archetypeStorage<TArchetype>().createEntity();
         }
 
+        /**
+         * @brief Creates count entities at once and returns their contiguous index range.
+         *
+         * Each optional source array holds count components of one type and is
+         * memcpy'd into its column, so those components must be trivially copyable.
+         * Components without a source are default initialised.
+         *
+         * @param size_t count: Number of entities to create.
+         * @param const TComponents*... sources: Initial component values.
+         */
+        template <typename TArchetype, typename... TComponents>
+        EntityRange<TArchetype> createEntities(size_t count, const TComponents*... sources)
+        {
+            static_assert(Settings::template isArchetype<TArchetype>(), "TArchetype must be an archetype");
+            static_assert((mpl::Contains<TComponents, TArchetype>::value && ...), "Every source component must be part of TArchetype");
+
+            auto& as = archetypeStorage<TArchetype>();
+            EntityRange<TArchetype> range = as.createEntities(count);
+            (as.copyComponents(range, sources), ...);
+            return range;
+        }
+
+        /**
+         * @brief Returns a reference to the component, or a SplitReference when
+         * TComponent is a split component.
+         */
         template <typename TComponent, typename TArchetype>
-        TComponent& component(EntityIndex<TArchetype> index) noexcept
+        decltype(auto) component(EntityIndex<TArchetype> index) noexcept
+        {
+            static_assert(Settings::template isArchetype<TArchetype>(), "TArchetype must be an archetype");
+            static_assert(Settings::template isComponent<TComponent>(), "TComponent must be a component");
+
+            return archetypeStorage<TArchetype>().template component<TComponent>(index);
+        }
+
+        /**
+         * @brief Read-only access, which unlike the mutable one never marks the
+         * component as changed and so is safe to use from several threads.
+         */
+        template <typename TComponent, typename TArchetype>
+        decltype(auto) component(EntityIndex<TArchetype> index) const noexcept
         {
             static_assert(Settings::template isArchetype<TArchetype>(), "TArchetype must be an archetype");
             static_assert(Settings::template isComponent<TComponent>(), "TComponent must be a component");
@@ -66,6 +328,115 @@ namespace sxi::ecs
             archetypeStorage<TArchetype>().kill(index);
         }
 
+        template <typename TArchetype>
+        bool isEnabled(EntityIndex<TArchetype> index) const noexcept
+        {
+            static_assert(Settings::template isArchetype<TArchetype>(), "TArchetype must be an archetype");
+
+            return archetypeStorage<TArchetype>().isEnabled(index);
+        }
+
+        /**
+         * @brief Parks or unparks an entity. Disabled entities keep their index, handles
+         * and components but are skipped by every forEntitiesMatching/forChunksMatching
+         * style query. Not thread-safe, use the command buffer from parallel systems.
+         */
+        template <typename TArchetype>
+        void setEnabled(EntityIndex<TArchetype> index, bool enabled) noexcept
+        {
+            static_assert(Settings::template isArchetype<TArchetype>(), "TArchetype must be an archetype");
+
+            archetypeStorage<TArchetype>().setEnabled(index, enabled);
+        }
+
+        static constexpr u64 snapshotLayoutHash() noexcept
+        {
+            u64 hash = 0xcbf29ce484222325;
+            mpl::forTypes<ArchetypeList>([&hash](auto t){
+                hash = detail::ArchetypeStorage<TSettings, SXI_MPL_TYPE(t)>::layoutHash(hash);
+            });
+            return hash;
+        }
+
+        /**
+         * @brief Writes every archetype's entities to a versioned binary file, column
+         * by column. Call it right after refresh: pending creations, kills and
+         * commands are not saved, neither are handles.
+         *
+         * @param const std::string& path: File to create or overwrite.
+         */
+        void saveSnapshot(const std::string& path) const
+        {
+            detail::SnapshotWriter out(path);
+            out.write(detail::SnapshotHeader{ detail::SNAPSHOT_MAGIC, detail::SNAPSHOT_VERSION, snapshotLayoutHash(), currentVersion });
+            mpl::forTuple([&out](const auto& as){
+                as.save(out);
+            }, archetypes);
+            out.finish();
+        }
+
+        /**
+         * @brief Replaces the world with one written by saveSnapshot.
+         *
+         * The file is memory mapped and every column is memcpy'd in one go per
+         * contiguous run, so loading is bound by disk bandwidth rather than by entity
+         * construction. Throws InvalidArgumentException when the file is not a
+         * snapshot of the same settings or is corrupt, in which case the world is
+         * left untouched. Every existing handle becomes invalid.
+         */
+        void loadSnapshot(const std::string& path)
+        {
+            file::MappedFile file(path);
+            detail::SnapshotReader in(file.data(), file.size());
+
+            detail::SnapshotHeader header = in.read<detail::SnapshotHeader>();
+            if (header.magic != detail::SNAPSHOT_MAGIC || header.formatVersion != detail::SNAPSHOT_VERSION)
+                throw InvalidArgumentException("Not a snapshot file or unsupported snapshot version");
+            if (header.layoutHash != snapshotLayoutHash())
+                throw InvalidArgumentException("Snapshot was written with different ECS settings");
+
+            // every archetype is parsed before any is replaced. Not through
+            // mpl::forTuple, which is noexcept and would turn a corrupt file into
+            // std::terminate
+            sxi::mpl::Rename<TupleOfArchetypeStorages, ArchetypeList> loaded;
+            std::apply([&in, &header](auto&... as){
+                (as.load(in, header.worldVersion), ...);
+            }, loaded);
+
+            for (CommandBuffer<TSettings>& cb : commandBuffers)
+                mpl::forTypes<ArchetypeList>([&cb](auto t){
+                    cb.template archetypeCommands<SXI_MPL_TYPE(t)>().clear();
+                });
+            mpl::forTuple([](auto& pending){
+                pending.sources.clear();
+            }, migrations);
+            handleAliases.clear();
+            freeHandleAliases.clear();
+
+            currentVersion = header.worldVersion;
+            mpl::forTypes<ArchetypeList>([this, &loaded](auto t){
+                using TArchetype = SXI_MPL_TYPE(t);
+                archetypeStorage<TArchetype>().replaceWith(std::move(std::get<detail::ArchetypeStorage<TSettings, TArchetype>>(loaded)));
+            });
+        }
+
+        /**
+         * @brief Reorders TArchetype's entities by keyFunc(const TKeyComponents&...),
+         * e.g. by model and texture so draws batch up, or by cell for spatial queries.
+         *
+         * Cheap when the storage is already nearly sorted, so it can run every frame.
+         * Entities created since the last refresh keep their place at the end.
+         * Invalidates entity indices, handles are patched. Not thread-safe.
+         */
+        template <typename TArchetype, typename... TKeyComponents, typename Func>
+        void sortBy(Func&& keyFunc)
+        {
+            static_assert(Settings::template isArchetype<TArchetype>(), "TArchetype must be an archetype");
+            static_assert((mpl::Contains<TKeyComponents, TArchetype>::value && ...), "Every key component must be part of TArchetype");
+
+            archetypeStorage<TArchetype>().template sortBy<TKeyComponents...>(keyFunc);
+        }
+
         template <typename TArchetype>
         [[nodiscard]] EntityHandle<TArchetype> createHandle(EntityIndex<TArchetype> index)
         {
@@ -74,8 +445,62 @@ namespace sxi::ecs
             return archetypeStorage<TArchetype>().createHandle(index);
         }
 
+        /**
+         * @brief Moves an entity to TTo during the next refresh.
+         *
+         * Components shared by both archetypes are moved over column by column, the
+         * others start default initialised. The entity's TFrom index dies like on
+         * kill. Its TFrom handles stay tied to it: they report dead while it lives
+         * in another archetype, migratedHandle<TTo> turns them into TTo handles,
+         * and they come back to life should it migrate back to TFrom. The pair must
+         * be listed in the settings' MigrationList. Not thread-safe.
+         */
+        template <typename TFrom, typename TTo>
+        void migrate(EntityIndex<TFrom> index)
+        {
+            static_assert(!std::is_same_v<TFrom, TTo>, "Cannot migrate an entity to its own archetype");
+
+            pendingMigrations<TFrom, TTo>().sources.push_back(index);
+        }
+
+        /**
+         * @brief Moves every live TFrom entity to TTo during the next refresh, like migrate.
+         */
+        template <typename TFrom, typename TTo>
+        void migrateAll()
+        {
+            static_assert(!std::is_same_v<TFrom, TTo>, "Cannot migrate an entity to its own archetype");
+
+            auto& pending = pendingMigrations<TFrom, TTo>().sources;
+            archetypeStorage<TFrom>().forEntities([this, &pending](EntityIndex<TFrom> index){
+                if (archetypeStorage<TFrom>().isAlive(index))
+                    pending.push_back(index);
+            });
+        }
+
+        /**
+         * @brief TTo handle of the entity a handle refers to, which is valid while
+         * the entity lives in TTo. The handle may be from any archetype the entity
+         * went through, invalid results mean it died or never reached TTo.
+         */
+        template <typename TTo, typename TFrom>
+        [[nodiscard]] EntityHandle<TTo> migratedHandle(const EntityHandle<TFrom>& handle) const noexcept
+        {
+            static_assert(Settings::template isArchetype<TFrom>(), "TFrom must be an archetype");
+            static_assert(Settings::template isArchetype<TTo>(), "TTo must be an archetype");
+
+            if constexpr (std::is_same_v<TFrom, TTo>)
+                return handle;
+            else
+            {
+                size_t alias = archetypeStorage<TFrom>().handleAlias(handle);
+                size_t slot = alias == std::numeric_limits<size_t>::max() ? alias : handleAliases[alias][mpl::IndexOf<TTo, ArchetypeList>::value];
+                return archetypeStorage<TTo>().handleTo(detail::EntityHandleDataIndex<TTo>{slot});
+            }
+        }
+
         template <typename TComponent, typename TArchetype>
-        TComponent& component(const EntityHandle<TArchetype>& handle) noexcept
+        decltype(auto) component(const EntityHandle<TArchetype>& handle) noexcept
         {
             static_assert(Settings::template isArchetype<TArchetype>(), "TArchetype must be an archetype");
             static_assert(Settings::template isComponent<TComponent>(), "TComponent must be a component");
@@ -107,13 +532,126 @@ namespace sxi::ecs
             return archetypeStorage<TArchetype>().isEntityHandleValid(handle);
         }
 
-        void refresh() noexcept
+        /**
+         * @brief Current index of the entity a valid handle refers to.
+         */
+        template <typename TArchetype>
+        [[nodiscard]] EntityIndex<TArchetype> entityIndex(const EntityHandle<TArchetype>& handle) const noexcept
         {
-            mpl::forTuple([](auto& as){
-                as.refresh();
+            static_assert(Settings::template isArchetype<TArchetype>(), "TArchetype must be an archetype");
+
+            return archetypeStorage<TArchetype>().entityIndex(handle);
+        }
+
+        void refresh()
+        {
+            SXI_PROFILE_SCOPE("refresh");
+
+            mpl::forTuple([this](auto& as){
+                applyCommands(as);
             }, archetypes);
+
+            mpl::forTypes<typename TSettings::MigrationList>([this](auto t){
+                using TMigration = SXI_MPL_TYPE(t);
+                auto& pending = pendingMigrations<typename TMigration::From, typename TMigration::To>();
+                if (pending.sources.empty())
+                    return;
+
+                using TFrom = typename TMigration::From;
+                using TTo = typename TMigration::To;
+                archetypeStorage<TTo>().adopt(archetypeStorage<TFrom>(), pending.sources, [this](detail::EntityHandleDataIndex<TFrom> slot){
+                    return forwardHandle<TFrom, TTo>(slot);
+                });
+                pending.sources.clear();
+            });
+
+            mpl::forTuple([this](auto& as){
+                as.refresh(currentVersion + 1);
+            }, archetypes);
+            releaseHandleAliases();
+            ++currentVersion;
+
+            mpl::forTuple([](auto& channel){
+                channel.clear();
+            }, eventChannels);
+            eventArena.reset();
         }
         
+        /**
+         * @brief Current world version, advanced by every refresh.
+         *
+         * Mutable access to a tracked component stamps the block of entities it
+         * belongs to with this version.
+         */
+        u64 version() const noexcept
+        {
+            return currentVersion;
+        }
+
+        /**
+         * @brief Calls func(index, const components...) on entities matching TSignature
+         * whose block had any of TChanged accessed mutably at or after sinceVersion.
+         *
+         * Granularity is a block of entities (a chunk for chunked archetypes), so
+         * unchanged neighbours of changed entities are visited too. Storing version()
+         * after the call and passing it next time never misses a change.
+         */
+        template <typename TSignature, typename... TChanged, typename Func>
+        void forEntitiesChanged(u64 sinceVersion, Func&& func) const
+        {
+            static_assert(Settings::template isSignature<TSignature>(), "TSignature is not a signature");
+            SXI_PROFILE_SCOPE("forEntitiesChanged", profiler::typeName<TSignature>());
+            static_assert(sizeof...(TChanged) > 0, "At least one component to watch is required");
+            static_assert((Settings::template isTracked<TChanged>() && ...), "TChanged must be tracked components");
+            static_assert((mpl::Contains<TChanged, TSignature>::value && ...), "TChanged must be part of TSignature");
+
+            forStoragesMatching<TSignature>([sinceVersion, &func](const auto& as){
+                as.template forChangedComponents<TSignature, mpl::typelist<TChanged...>>(sinceVersion, func);
+            });
+        }
+
+        /**
+         * @brief True when any of TChanged was accessed mutably at or after
+         * sinceVersion in the block of entities index belongs to, with the same
+         * granularity as forEntitiesChanged.
+         */
+        template <typename... TChanged, typename TArchetype>
+        [[nodiscard]] bool changedSince(EntityIndex<TArchetype> index, u64 sinceVersion) const noexcept
+        {
+            static_assert(Settings::template isArchetype<TArchetype>(), "TArchetype must be an archetype");
+            static_assert(sizeof...(TChanged) > 0, "At least one component to watch is required");
+            static_assert((Settings::template isTracked<TChanged>() && ...), "TChanged must be tracked components");
+
+            return archetypeStorage<TArchetype>().template entityChangedSince<mpl::typelist<TChanged...>>(index, sinceVersion);
+        }
+
+        /**
+         * @brief Calls func(index) on every TArchetype entity, enabled or not, in a
+         * block where any of TChanged was accessed mutably at or after sinceVersion.
+         * Unlike forEntitiesChanged it needs no registered signature.
+         */
+        template <typename TArchetype, typename... TChanged, typename Func>
+        void forIndicesChanged(u64 sinceVersion, Func&& func) const
+        {
+            static_assert(Settings::template isArchetype<TArchetype>(), "TArchetype must be an archetype");
+            static_assert(sizeof...(TChanged) > 0, "At least one component to watch is required");
+            static_assert((Settings::template isTracked<TChanged>() && ...), "TChanged must be tracked components");
+
+            archetypeStorage<TArchetype>().template forIndicesChanged<mpl::typelist<TChanged...>>(sinceVersion, func);
+        }
+
+        /**
+         * @brief Number of TArchetype entities as of the last refresh, dead or disabled
+         * ones included, i.e. one past the highest valid EntityIndex.
+         */
+        template <typename TArchetype>
+        [[nodiscard]] size_t entityCount() const noexcept
+        {
+            static_assert(Settings::template isArchetype<TArchetype>(), "TArchetype must be an archetype");
+
+            return archetypeStorage<TArchetype>().entityCount();
+        }
+
         template <typename Func>
         void forEntities(Func&& func)
         {
@@ -128,14 +666,115 @@ namespace sxi::ecs
             archetypeStorage<TArchetype>().forEntities(func);
         }
         
-        template <typename TSignature, typename Func>
+        /**
+         * @brief Calls func(index, components...) on every enabled entity whose
+         * archetype matches TSignature. Besides components and tags, signatures may
+         * hold Without, Optional and AnyOf terms, all resolved at compile time.
+         *
+         * Components listed in TReadList are passed const and, unlike the others,
+         * not marked as changed. Other entries of the list are ignored, so systems
+         * can pass their Reads as is.
+         */
+        template <typename TSignature, typename TReadList = ReadList<>, typename Func>
         void forEntitiesMatching(Func&& func)
         {
             static_assert(Settings::template isSignature<TSignature>(), "TSignature is not a signature");
+            SXI_PROFILE_SCOPE("forEntitiesMatching", profiler::typeName<TSignature>());
+
+            forStoragesMatching<TSignature>([this, &func](auto& as){
+                as.template forComponents<TSignature, TReadList>(func);
+            });
+        }
 
-            mpl::forTuple([this, &func](auto& as){
+        /**
+         * @brief Read-only forEntitiesMatching: every component is passed const
+         * and nothing is marked as changed.
+         */
+        template <typename TSignature, typename Func>
+        void forEntitiesMatching(Func&& func) const
+        {
+            static_assert(Settings::template isSignature<TSignature>(), "TSignature is not a signature");
+            SXI_PROFILE_SCOPE("forEntitiesMatching", profiler::typeName<TSignature>());
+
+            forStoragesMatching<TSignature>([&func](const auto& as){
                 as.template forComponents<TSignature>(func);
-            }, archetypes);
+            });
+        }
+
+        /**
+         * @brief Calls func(firstIndex, std::span<Ts>...) once per contiguous run of
+         * entities matching TSignature, with one span per signature component.
+         * Split components are passed as a SplitSpan exposing one raw column per field.
+         *
+         * Runs cover a whole archetype for vector storage and a single chunk for
+         * chunked storage, which lets kernels loop over plain arrays. Components
+         * in TReadList come as spans of const and are not marked as changed.
+         */
+        template <typename TSignature, typename TReadList = ReadList<>, typename Func>
+        void forChunksMatching(Func&& func)
+        {
+            static_assert(Settings::template isSignature<TSignature>(), "TSignature is not a signature");
+            SXI_PROFILE_SCOPE("forChunksMatching", profiler::typeName<TSignature>());
+
+            forStoragesMatching<TSignature>([&func](auto& as){
+                as.template forChunks<TSignature, TReadList>(func);
+            });
+        }
+
+        /**
+         * @brief Read-only forChunksMatching: every span is const and nothing is
+         * marked as changed.
+         */
+        template <typename TSignature, typename Func>
+        void forChunksMatching(Func&& func) const
+        {
+            static_assert(Settings::template isSignature<TSignature>(), "TSignature is not a signature");
+            SXI_PROFILE_SCOPE("forChunksMatching", profiler::typeName<TSignature>());
+
+            forStoragesMatching<TSignature>([&func](const auto& as){
+                as.template forChunks<TSignature>(func);
+            });
+        }
+
+        /**
+         * @brief Same as forChunksMatching with runs further split into at most
+         * grainSize entities and spread across the job system.
+         */
+        template <typename TSignature, typename TReadList = ReadList<>, typename Func>
+        void forChunksMatchingParallel(Func&& func, size_t grainSize=4096)
+        {
+            static_assert(Settings::template isSignature<TSignature>(), "TSignature is not a signature");
+            SXI_PROFILE_SCOPE("forChunksMatchingParallel", profiler::typeName<TSignature>());
+            assert(grainSize > 0);
+
+            jobs::ThreadPool& pool = jobs::threadPool();
+            jobs::JobCounter counter;
+            forStoragesMatching<TSignature>([&pool, &counter, &func, grainSize](auto& as){
+                as.template forChunksParallel<TSignature, TReadList>(pool, counter, func, grainSize);
+            });
+            pool.wait(counter);
+        }
+
+        /**
+         * @brief Runs func on every entity matching TSignature across the job system.
+         *
+         * Each archetype's entities are split into chunks of grainSize and all chunks
+         * of all archetypes are queued at once, so func must be safe to call
+         * concurrently for different entities. Blocks until every chunk has run.
+         */
+        template <typename TSignature, typename TReadList = ReadList<>, typename Func>
+        void forEntitiesMatchingParallel(Func&& func, size_t grainSize=1024)
+        {
+            static_assert(Settings::template isSignature<TSignature>(), "TSignature is not a signature");
+            SXI_PROFILE_SCOPE("forEntitiesMatchingParallel", profiler::typeName<TSignature>());
+            assert(grainSize > 0);
+
+            jobs::ThreadPool& pool = jobs::threadPool();
+            jobs::JobCounter counter;
+            forStoragesMatching<TSignature>([&pool, &counter, &func, grainSize](auto& as){
+                as.template forComponentsParallel<TSignature, TReadList>(pool, counter, func, grainSize);
+            });
+            pool.wait(counter);
         }
     };
 }
\ No newline at end of file
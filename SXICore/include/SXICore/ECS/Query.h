@@ -0,0 +1,126 @@
+#pragma once
+
+#include <type_traits>
+
+#include "../MPL/TypeList.h"
+#include "../MPL/Contains.h"
+#include "../MPL/Filter.h"
+#include "../MPL/Map.h"
+
+namespace sxi::ecs
+{
+    template <typename... Ts> using ReadList = sxi::mpl::typelist<Ts...>;
+
+    /**
+     * @brief Signature term matching only archetypes that lack T.
+     */
+    template <typename T>
+    struct Without final {};
+
+    /**
+     * @brief Signature term for a component that may be missing.
+     *
+     * Entity callbacks receive a T*, null when the archetype has no T, and chunk
+     * callbacks a std::span<T> that is empty in that case.
+     */
+    template <typename T>
+    struct Optional final {};
+
+    /**
+     * @brief Signature term matching archetypes that contain at least one of Ts.
+     * It only filters, nothing is passed to callbacks for it.
+     */
+    template <typename... Ts>
+    struct AnyOf final {};
+
+    namespace detail
+    {
+        template <typename TArchetype, typename TTerm>
+        struct TermMatches : std::bool_constant<mpl::Contains<TTerm, TArchetype>::value> {};
+
+        template <typename TArchetype, typename T>
+        struct TermMatches<TArchetype, Without<T>> : std::bool_constant<!mpl::Contains<T, TArchetype>::value> {};
+
+        template <typename TArchetype, typename T>
+        struct TermMatches<TArchetype, Optional<T>> : std::true_type {};
+
+        template <typename TArchetype, typename... Ts>
+        struct TermMatches<TArchetype, AnyOf<Ts...>> : std::bool_constant<(mpl::Contains<Ts, TArchetype>::value || ...)> {};
+
+        template <typename TArchetype, typename TSignature>
+        struct SignatureMatches;
+
+        template <typename TArchetype, typename... Ts>
+        struct SignatureMatches<TArchetype, mpl::typelist<Ts...>>
+            : std::bool_constant<(TermMatches<TArchetype, Ts>::value && ...)> {};
+
+        template <typename T>
+        struct IsOptional : std::false_type {};
+
+        template <typename T>
+        struct IsOptional<Optional<T>> : std::true_type {};
+
+        template <typename T>
+        struct Unwrap
+        {
+            using type = T;
+        };
+
+        template <typename T>
+        struct Unwrap<Optional<T>>
+        {
+            using type = T;
+        };
+
+        template <typename T>
+        using Unwrapped = typename Unwrap<T>::type;
+
+        template <typename TSignature>
+        struct MatchesSignature
+        {
+            template <typename TArchetype>
+            using Filter = std::bool_constant<SignatureMatches<TArchetype, TSignature>::value>;
+        };
+
+        template <typename TList>
+        struct NotIn
+        {
+            template <typename T>
+            using Filter = std::bool_constant<!mpl::Contains<T, TList>::value && !mpl::Contains<Unwrapped<T>, TList>::value>;
+        };
+
+        template <typename TSettings>
+        struct IsQueryComponent
+        {
+            template <typename T>
+            using Filter = std::bool_constant<TSettings::template isComponent<Unwrapped<T>>()>;
+        };
+    }
+
+    /**
+     * @brief True when every term of TSignature accepts TArchetype: plain
+     * components and tags must be present, Without terms absent and AnyOf terms
+     * satisfied by at least one type.
+     */
+    template <typename TArchetype, typename TSignature>
+    constexpr bool matches() noexcept
+    {
+        return detail::SignatureMatches<TArchetype, TSignature>::value;
+    }
+
+    // terms handed to callbacks in signature order: components and Optional components
+    template <typename TSettings, typename TSignature>
+    using QueryComponents = mpl::Filter<detail::IsQueryComponent<TSettings>::template Filter, TSignature>;
+
+    // components a query may touch, with Optional unwrapped
+    template <typename TSettings, typename TSignature>
+    using AccessedComponents = mpl::Map<detail::Unwrapped, QueryComponents<TSettings, TSignature>>;
+
+    // archetypes of the settings that TSignature visits, in ArchetypeList order
+    template <typename TSettings, typename TSignature>
+    using MatchingArchetypes = mpl::Filter<detail::MatchesSignature<TSignature>::template Filter, typename TSettings::ArchetypeList>;
+
+    // components a query hands out mutably, which are the ones it marks as changed
+    template <typename TSettings, typename TSignature, typename TReadList>
+    using WrittenComponents = mpl::Filter<detail::NotIn<TReadList>::template Filter, AccessedComponents<TSettings, TSignature>>;
+}
\ No newline at end of file
@@ -0,0 +1,244 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "Manager.h"
+#include "Query.h"
+#include "../Jobs/ThreadPool.h"
+#include "../Profiler.h"
+
+#include "../MPL/TypeList.h"
+#include "../MPL/Tuple.h"
+#include "../MPL/Count.h"
+#include "../MPL/Filter.h"
+#include "../MPL/Concat.h"
+#include "../MPL/Contains.h"
+#include "../MPL/Intersects.h"
+#include "../MPL/Fold.h"
+
+namespace sxi::ecs
+{
+    template <typename... Ts> using WriteList = sxi::mpl::typelist<Ts...>;
+    template <typename... Ts> using SystemList = sxi::mpl::typelist<Ts...>;
+
+    namespace detail
+    {
+        template <typename TSettings, typename TArchetype, typename TSystem, typename TOther>
+        constexpr bool conflictsIn() noexcept
+        {
+            if constexpr(!matches<TArchetype, typename TSystem::Signature>() ||
+                         !matches<TArchetype, typename TOther::Signature>())
+            {
+                return false;
+            }
+            else
+            {
+                using Writes = AccessedComponents<TSettings, typename TSystem::Writes>;
+                using OtherWrites = AccessedComponents<TSettings, typename TOther::Writes>;
+                using Reads = AccessedComponents<TSettings, typename TSystem::Reads>;
+                using OtherReads = AccessedComponents<TSettings, typename TOther::Reads>;
+
+                return mpl::Intersects<Writes, OtherWrites>::value ||
+                       mpl::Intersects<Writes, OtherReads>::value ||
+                       mpl::Intersects<OtherWrites, Reads>::value;
+            }
+        }
+
+        // resources exist once per world, so they conflict regardless of signatures
+        template <typename TSettings, typename TSystem, typename TOther>
+        constexpr bool resourcesConflict() noexcept
+        {
+            using Writes = mpl::Filter<TSettings::template IsResourceFilter, typename TSystem::Writes>;
+            using OtherWrites = mpl::Filter<TSettings::template IsResourceFilter, typename TOther::Writes>;
+            using Reads = mpl::Filter<TSettings::template IsResourceFilter, typename TSystem::Reads>;
+            using OtherReads = mpl::Filter<TSettings::template IsResourceFilter, typename TOther::Reads>;
+
+            return mpl::Intersects<Writes, OtherWrites>::value ||
+                   mpl::Intersects<Writes, OtherReads>::value ||
+                   mpl::Intersects<OtherWrites, Reads>::value;
+        }
+
+        // appends are lock-free, so only an emitter and a reader of the same event conflict
+        template <typename TSettings, typename TSystem, typename TOther>
+        constexpr bool eventsConflict() noexcept
+        {
+            using Emits = mpl::Filter<TSettings::template IsEventFilter, typename TSystem::Writes>;
+            using OtherEmits = mpl::Filter<TSettings::template IsEventFilter, typename TOther::Writes>;
+            using Reads = mpl::Filter<TSettings::template IsEventFilter, typename TSystem::Reads>;
+            using OtherReads = mpl::Filter<TSettings::template IsEventFilter, typename TOther::Reads>;
+
+            return mpl::Intersects<Emits, OtherReads>::value ||
+                   mpl::Intersects<OtherEmits, Reads>::value;
+        }
+
+        // refresh drops every event, so a reader listed before an emitter would never see its events
+        template <typename TSettings, typename TSystem, typename TOther>
+        constexpr bool readsEventsEmittedBy() noexcept
+        {
+            using Reads = mpl::Filter<TSettings::template IsEventFilter, typename TSystem::Reads>;
+            using OtherEmits = mpl::Filter<TSettings::template IsEventFilter, typename TOther::Writes>;
+
+            return mpl::Intersects<Reads, OtherEmits>::value;
+        }
+
+        template <typename TSettings, typename TSystem, typename TOther, typename TArchetypeList>
+        struct SystemsConflict;
+
+        template <typename TSettings, typename TSystem, typename TOther, typename... TArchetypes>
+        struct SystemsConflict<TSettings, TSystem, TOther, mpl::typelist<TArchetypes...>>
+        {
+            static constexpr bool value = resourcesConflict<TSettings, TSystem, TOther>() ||
+                                          eventsConflict<TSettings, TSystem, TOther>() ||
+                                          mpl::any<conflictsIn<TSettings, TArchetypes, TSystem, TOther>()...>();
+        };
+    }
+
+    /**
+     * @brief Convenience base for systems.
+     *
+     * Every component in TSignature that is not listed in TReadList is treated
+     * as written. Resources the system reads go in TReadList, the ones it writes
+     * in TWriteList. Events it reads go in TReadList, the ones it emits in
+     * TWriteList.
+     *
+     * Queries only mark what they hand out mutably as changed, so pass Reads as
+     * their read list, e.g. mgr.forEntitiesMatching<Signature, Reads>(func).
+     * Otherwise two systems reading the same component both stamp it.
+     */
+    template <typename TSignature, typename TReadList = ReadList<>, typename TWriteList = WriteList<>>
+    struct System
+    {
+        using Signature = TSignature;
+        using Reads = TReadList;
+        using Writes = mpl::Concat<mpl::Filter<detail::NotIn<TReadList>::template Filter, TSignature>, TWriteList>;
+    };
+
+    /**
+     * @brief Runs a list of systems every frame on the job system.
+     *
+     * A system is any default-constructible type exposing Signature, Reads and
+     * Writes typelists plus a run(Manager&, Args&...) method. Two systems
+     * conflict when some archetype matches both their signatures and one of
+     * them writes a component the other reads or writes, or when one of them
+     * writes a resource the other reads or writes, or when one of them emits an
+     * event the other reads. Conflicting systems run in SystemList order, every
+     * other pair is free to run concurrently. Systems reading an event have to
+     * be listed after every system emitting it.
+     * The dependency graph is built entirely at compile time.
+     */
+    template <typename TSettings, typename TSystemList>
+    class Scheduler final
+    {
+        using Systems = mpl::Tuple<TSystemList>;
+        static constexpr size_t systemCount = mpl::Count<TSystemList>::value;
+        using DependencyMatrix = std::array<std::array<bool, systemCount>, systemCount>;
+
+        template <size_t I>
+        using SystemAt = std::tuple_element_t<I, Systems>;
+
+        template <size_t I, size_t... Js>
+        static constexpr void fillDependencies(DependencyMatrix& dependencies, std::index_sequence<Js...>) noexcept
+        {
+            ((dependencies[I][Js] = Js < I && detail::SystemsConflict<
+                TSettings, SystemAt<I>, SystemAt<Js>, typename TSettings::ArchetypeList>::value), ...);
+        }
+
+        template <size_t... Is>
+        static constexpr DependencyMatrix buildDependencies(std::index_sequence<Is...>) noexcept
+        {
+            DependencyMatrix dependencies{};
+            (fillDependencies<Is>(dependencies, std::make_index_sequence<systemCount>{}), ...);
+            return dependencies;
+        }
+
+        // dependencies[i][j] is true when system i has to wait for system j
+        static constexpr DependencyMatrix dependencies = buildDependencies(std::make_index_sequence<systemCount>{});
+
+        static constexpr std::array<size_t, systemCount> buildDependencyCounts() noexcept
+        {
+            std::array<size_t, systemCount> counts{};
+            for (size_t i = 0; i < systemCount; ++i)
+                for (size_t j = 0; j < systemCount; ++j)
+                    counts[i] += dependencies[i][j];
+            return counts;
+        }
+
+        static constexpr std::array<size_t, systemCount> dependencyCounts = buildDependencyCounts();
+
+        template <size_t I, size_t... Js>
+        static constexpr bool readsEventsEmittedLater(std::index_sequence<Js...>) noexcept
+        {
+            return mpl::any<(I < Js && detail::readsEventsEmittedBy<TSettings, SystemAt<I>, SystemAt<Js>>())...>();
+        }
+
+        template <size_t... Is>
+        static constexpr bool eventsInOrder(std::index_sequence<Is...>) noexcept
+        {
+            return !mpl::any<readsEventsEmittedLater<Is>(std::make_index_sequence<systemCount>{})...>();
+        }
+
+        static_assert(eventsInOrder(std::make_index_sequence<systemCount>{}),
+            "Systems reading an event must be listed after every system emitting it");
+
+        template <typename... Args, size_t... Is>
+        std::array<std::function<void()>, systemCount> makeTasks(Manager<TSettings>& mgr, std::index_sequence<Is...>, Args&... args)
+        {
+            return { [this, &mgr, &args...](){
+                SXI_PROFILE_SCOPE(profiler::typeName<SystemAt<Is>>());
+                std::get<Is>(systems).run(mgr, args...);
+            }... };
+        }
+
+        Systems systems;
+
+    public:
+        template <typename TSystem>
+        TSystem& system() noexcept
+        {
+            return std::get<TSystem>(systems);
+        }
+
+        template <typename TSystem, typename TOther>
+        static constexpr bool conflicts() noexcept
+        {
+            return detail::SystemsConflict<TSettings, TSystem, TOther, typename TSettings::ArchetypeList>::value;
+        }
+
+        /**
+         * @brief Runs every system once and returns when all of them finished.
+         *
+         * @param Manager<TSettings>& mgr: World the systems operate on.
+         * @param Args&... args: Forwarded by reference to every system's run.
+         */
+        template <typename... Args>
+        void run(Manager<TSettings>& mgr, Args&... args)
+        {
+            SXI_PROFILE_SCOPE("Scheduler::run");
+
+            std::array<std::function<void()>, systemCount> tasks = makeTasks(mgr, std::make_index_sequence<systemCount>{}, args...);
+            std::array<std::atomic<size_t>, systemCount> remaining;
+            for (size_t i = 0; i < systemCount; ++i)
+                remaining[i].store(dependencyCounts[i], std::memory_order_relaxed);
+
+            jobs::ThreadPool& pool = jobs::threadPool();
+            jobs::JobCounter counter;
+            std::function<void(size_t)> launch = [&](size_t i){
+                pool.submit([&, i](){
+                    tasks[i]();
+                    for (size_t j = i + 1; j < systemCount; ++j)
+                        if (dependencies[j][i] && remaining[j].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                            launch(j);
+                }, &counter);
+            };
+
+            for (size_t i = 0; i < systemCount; ++i)
+                if (dependencyCounts[i] == 0)
+                    launch(i);
+            pool.wait(counter);
+        }
+    };
+}
@@ -2,6 +2,8 @@
 
 #include <type_traits>
 
+#include "ColumnAllocator.h"
+
 #include "../MPL/TypeList.h"
 #include "../MPL/Contains.h"
 #include "../MPL/Count.h"
@@ -19,11 +21,37 @@ namespace sxi::ecs
     template <typename... Ts> using Archetype = sxi::mpl::typelist<Ts...>;
     template <typename... Ts> using ArchetypeList = sxi::mpl::typelist<Ts...>;
 
+    // allows Manager::migrate<TFrom, TTo>, which moves the shared columns in bulk
+    template <typename TFrom, typename TTo>
+    struct Migration
+    {
+        using From = TFrom;
+        using To = TTo;
+    };
+    template <typename... Ts> using MigrationList = sxi::mpl::typelist<Ts...>;
+
+    template <typename... Ts> using ResourceList = sxi::mpl::typelist<Ts...>;
+
+    template <typename... Ts> using EventList = sxi::mpl::typelist<Ts...>;
+
+    /**
+     * @brief Compile-time description of a world, passed to Manager and Scheduler.
+     *
+     * Prefer deriving a named struct from it over a using alias: every type the
+     * ECS instantiates is spelled in terms of the settings, and with hundreds of
+     * components compilers spend most of their time walking those lists.
+     */
     template <
         typename TComponentList,
         typename TTagList,
         typename TArchetypeList,
-        typename TSignatureList
+        typename TSignatureList,
+        typename TChunkedArchetypeList = ArchetypeList<>,
+        typename TTrackedComponentList = ComponentList<>,
+        typename TMigrationList = MigrationList<>,
+        typename TColumnAllocator = ColumnAllocator<>,
+        typename TResourceList = ResourceList<>,
+        typename TEventList = EventList<>
     >
     struct Settings
     {
@@ -31,7 +59,23 @@ namespace sxi::ecs
         using TagList = TTagList;
         using ArchetypeList = TArchetypeList;
         using SignatureList = TSignatureList;
-        using TSettings = Settings<ComponentList, TagList, ArchetypeList, SignatureList>;
+        using ChunkedArchetypeList = TChunkedArchetypeList;
+        using TrackedComponentList = TTrackedComponentList;
+        using MigrationList = TMigrationList;
+        using ColumnAllocator = TColumnAllocator;
+        using ResourceList = TResourceList;
+        using EventList = TEventList;
+        using TSettings = Settings<
+            ComponentList,
+            TagList,
+            ArchetypeList,
+            SignatureList,
+            ChunkedArchetypeList,
+            TrackedComponentList,
+            MigrationList,
+            ColumnAllocator,
+            ResourceList,
+            EventList>;
 
         template <typename T>
         static constexpr bool isComponent() noexcept
@@ -57,6 +101,36 @@ namespace sxi::ecs
             return mpl::Contains<T, SignatureList>::value;
         }
 
+        template <typename T>
+        static constexpr bool isChunked() noexcept
+        {
+            return mpl::Contains<T, ChunkedArchetypeList>::value;
+        }
+
+        template <typename T>
+        static constexpr bool isTracked() noexcept
+        {
+            return mpl::Contains<T, TrackedComponentList>::value;
+        }
+
+        template <typename TFrom, typename TTo>
+        static constexpr bool isMigration() noexcept
+        {
+            return mpl::Contains<Migration<TFrom, TTo>, MigrationList>::value;
+        }
+
+        template <typename T>
+        static constexpr bool isResource() noexcept
+        {
+            return mpl::Contains<T, ResourceList>::value;
+        }
+
+        template <typename T>
+        static constexpr bool isEvent() noexcept
+        {
+            return mpl::Contains<T, EventList>::value;
+        }
+
         static constexpr size_t componentCount() noexcept
         {
             return mpl::Count<ComponentList>::value;
@@ -77,6 +151,16 @@ namespace sxi::ecs
             return mpl::Count<SignatureList>::value;
         }
 
+        static constexpr size_t resourceCount() noexcept
+        {
+            return mpl::Count<ResourceList>::value;
+        }
+
+        static constexpr size_t eventCount() noexcept
+        {
+            return mpl::Count<EventList>::value;
+        }
+
         template <typename T>
         static constexpr size_t componentId() noexcept
         {
@@ -104,9 +188,18 @@ namespace sxi::ecs
         template <typename TComponent>
         using IsComponentFilter = std::bool_constant<isComponent<TComponent>()>;
 
+        template <typename TComponent>
+        using IsTrackedFilter = std::bool_constant<isTracked<TComponent>()>;
+
         template <typename TTag>
         using IsTagFilter = std::bool_constant<isTag<TTag>()>;
 
+        template <typename TResource>
+        using IsResourceFilter = std::bool_constant<isResource<TResource>()>;
+
+        template <typename TEvent>
+        using IsEventFilter = std::bool_constant<isEvent<TEvent>()>;
+
         template <typename TSignature>
         using SignatureComponents = mpl::Filter<IsComponentFilter, TSignature>;
 
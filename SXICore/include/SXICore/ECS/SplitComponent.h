@@ -0,0 +1,202 @@
+#pragma once
+
+#include <stddef.h>
+#include <array>
+#include <bit>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "../MPL/TypeList.h"
+#include "../MPL/Concat.h"
+
+namespace sxi::ecs
+{
+    /**
+     * @brief Opt-in trait storing a component field by field.
+     *
+     * Specialise it with the field type and count for a trivially copyable
+     * component made of fieldCount consecutive Fields, e.g. a glm::vec3. Archetype
+     * storage then keeps one column per field, component<T>() returns a
+     * SplitReference and chunk iteration hands out a SplitSpan instead of a
+     * std::span<T>. Callbacks receiving split components should take them by
+     * auto&& or by value. Declare the specialisation next to the component, so
+     * no translation unit sees the component without it.
+     *
+     * template <> struct sxi::ecs::SplitComponent<PositionComponent>
+     * {
+     *     using Field = float;
+     *     static constexpr size_t fieldCount = 3;
+     * };
+     */
+    template <typename T>
+    struct SplitComponent
+    {
+        static constexpr size_t fieldCount = 0;
+    };
+
+    template <typename T>
+    constexpr bool isSplitComponent() noexcept
+    {
+        return SplitComponent<std::remove_const_t<T>>::fieldCount > 0;
+    }
+
+    /**
+     * @brief Proxy for a split component. Converts to T, assigns from T and
+     * gives access to single fields without touching the others.
+     */
+    template <typename T>
+    class SplitReference final
+    {
+        using Value = std::remove_const_t<T>;
+        using Traits = SplitComponent<Value>;
+        using Field = std::conditional_t<std::is_const_v<T>, const typename Traits::Field, typename Traits::Field>;
+        static constexpr size_t fieldCount = Traits::fieldCount;
+
+        static_assert(std::is_trivially_copyable_v<Value>, "Split components must be trivially copyable");
+        static_assert(sizeof(Value) == sizeof(typename Traits::Field) * fieldCount, "Split components must consist of fieldCount Fields only");
+
+        std::array<Field*, fieldCount> fields;
+
+    public:
+        explicit SplitReference(const std::array<Field*, fieldCount>& fields) noexcept : fields(fields) {}
+
+        SplitReference(const SplitReference&) = default;
+
+        const SplitReference& operator=(const SplitReference& other) const noexcept requires (!std::is_const_v<T>)
+        {
+            return *this = other.value();
+        }
+
+        const SplitReference& operator=(const Value& value) const noexcept requires (!std::is_const_v<T>)
+        {
+            auto values = std::bit_cast<std::array<typename Traits::Field, fieldCount>>(value);
+            for (size_t i = 0; i < fieldCount; ++i)
+                *fields[i] = values[i];
+            return *this;
+        }
+
+        [[nodiscard]] Value value() const noexcept
+        {
+            std::array<typename Traits::Field, fieldCount> values;
+            for (size_t i = 0; i < fieldCount; ++i)
+                values[i] = *fields[i];
+            return std::bit_cast<Value>(values);
+        }
+
+        operator Value() const noexcept
+        {
+            return value();
+        }
+
+        [[nodiscard]] Field& field(size_t i) const noexcept
+        {
+            return *fields[i];
+        }
+
+        template <size_t I>
+        [[nodiscard]] Field& field() const noexcept
+        {
+            static_assert(I < fieldCount, "Field index out of range");
+            return *fields[I];
+        }
+    };
+
+    /**
+     * @brief Contiguous run of split components, one raw column per field.
+     */
+    template <typename T>
+    class SplitSpan final
+    {
+        using Traits = SplitComponent<std::remove_const_t<T>>;
+        using Field = std::conditional_t<std::is_const_v<T>, const typename Traits::Field, typename Traits::Field>;
+        static constexpr size_t fieldCount = Traits::fieldCount;
+
+        std::array<Field*, fieldCount> columns;
+        size_t count;
+
+    public:
+        class Iterator final
+        {
+            const SplitSpan* span;
+            size_t index;
+
+        public:
+            Iterator(const SplitSpan* span, size_t index) noexcept : span(span), index(index) {}
+
+            SplitReference<T> operator*() const noexcept { return (*span)[index]; }
+            Iterator& operator++() noexcept { ++index; return *this; }
+            bool operator==(const Iterator& other) const noexcept { return index == other.index; }
+            bool operator!=(const Iterator& other) const noexcept { return index != other.index; }
+        };
+
+        SplitSpan(const std::array<Field*, fieldCount>& columns, size_t count) noexcept : columns(columns), count(count) {}
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return count;
+        }
+
+        [[nodiscard]] SplitReference<T> operator[](size_t index) const noexcept
+        {
+            std::array<Field*, fieldCount> fields;
+            for (size_t i = 0; i < fieldCount; ++i)
+                fields[i] = columns[i] + index;
+            return SplitReference<T>(fields);
+        }
+
+        /**
+         * @brief Raw column of one field, aligned like every other column.
+         */
+        [[nodiscard]] std::span<Field> field(size_t i) const noexcept
+        {
+            return std::span<Field>(columns[i], count);
+        }
+
+        template <size_t I>
+        [[nodiscard]] std::span<Field> field() const noexcept
+        {
+            static_assert(I < fieldCount, "Field index out of range");
+            return field(I);
+        }
+
+        [[nodiscard]] Iterator begin() const noexcept { return Iterator(this, 0); }
+        [[nodiscard]] Iterator end() const noexcept { return Iterator(this, count); }
+    };
+
+    namespace detail
+    {
+        // column type holding field I of the split component T
+        template <typename T, size_t I>
+        struct FieldColumn final
+        {
+            typename SplitComponent<T>::Field value;
+        };
+
+        template <typename T, typename TIndices>
+        struct FieldColumns;
+
+        template <typename T, size_t... Is>
+        struct FieldColumns<T, std::index_sequence<Is...>>
+        {
+            using type = mpl::typelist<FieldColumn<T, Is>...>;
+        };
+
+        template <typename T>
+        struct ColumnsOf
+        {
+            using type = std::conditional_t<isSplitComponent<T>(),
+                typename FieldColumns<T, std::make_index_sequence<SplitComponent<T>::fieldCount>>::type,
+                mpl::typelist<T>>;
+        };
+
+        template <typename TComponentList>
+        struct StoredColumns;
+
+        template <typename... Ts>
+        struct StoredColumns<mpl::typelist<Ts...>>
+        {
+            using type = mpl::Concat<typename ColumnsOf<Ts>::type...>;
+        };
+    }
+}
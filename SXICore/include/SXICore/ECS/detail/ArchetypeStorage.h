@@ -2,9 +2,28 @@
 
 #include "../../MPL/Filter.h"
 #include "../../MPL/Rename.h"
-#include "../../MPL/IsSubset.h"
 #include "../../MPL/TypeListOperations.h"
+#include "../../MPL/Count.h"
+#include "../../MPL/IndexOf.h"
+#include "../../Types.h"
+#include "../../Jobs/ThreadPool.h"
+#include "../Query.h"
+#include "../SplitComponent.h"
+#include "VectorColumns.h"
+#include "ChunkedColumns.h"
+#include "Snapshot.h"
 #include <assert.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include <iostream>
 
 namespace sxi::ecs::detail
@@ -12,27 +31,61 @@ namespace sxi::ecs::detail
     template <typename TSettings, typename TArchetype>
 	class ArchetypeStorage final 
 	{
+		template <typename, typename>
+		friend class ArchetypeStorage;
+
 		size_t size{};
 		size_t newSize{};
 		size_t capacity{};
 
 		using ArchetypeComponents = mpl::Filter<TSettings::template IsComponentFilter, TArchetype>;
+		// split components are stored as one column per field
+		using StoredComponents = typename StoredColumns<ArchetypeComponents>::type;
 
-		template <typename... Ts>
-    	using TupleOfVectors = std::tuple<std::vector<Ts>...>;
-		sxi::mpl::Rename<TupleOfVectors, ArchetypeComponents> components;
+		using Columns = std::conditional_t<TSettings::template isChunked<TArchetype>(),
+			ChunkedColumns<typename TSettings::ColumnAllocator, StoredComponents>,
+			VectorColumns<typename TSettings::ColumnAllocator, StoredComponents>>;
+		Columns components;
+
+		using TrackedComponents = mpl::Filter<TSettings::template IsTrackedFilter, ArchetypeComponents>;
+
+		static constexpr size_t versionBlockSize() noexcept
+		{
+			if constexpr (TSettings::template isChunked<TArchetype>())
+				return Columns::entitiesPerChunk;
+			else
+				return 1024;
+		}
+
+		// versions[c][b] is the world version in which tracked component c of
+		// block b was last accessed mutably
+		std::array<std::vector<u64>, mpl::Count<TrackedComponents>::value> versions;
+		u64 currentVersion = 1;
 
 		std::vector<Entity<TArchetype>> entities;
 		std::vector<EntityHandleData<TArchetype>> handleDatas;
+		std::vector<EntityHandleDataIndex<TArchetype>> freeHandleDatas;
+		// aliases of entities that died here, the manager frees their other slots
+		std::vector<size_t> releasedAliases;
+		std::vector<size_t> deadIndices;
+
+		// one bit per entity, set while the entity takes part in queries
+		std::vector<u64> enabledBits;
+		size_t disabledCount{};
 
 		void reserve(size_t newCapacity)
 		{
 			assert(newCapacity > capacity);
 			
+			// chunked columns round up to whole chunks
+			components.reserve(newCapacity);
+			newCapacity = components.capacity();
 			entities.resize(newCapacity);
-			sxi::mpl::forTuple([newCapacity](auto& c){
-				c.resize(newCapacity);
-			}, components);
+			// every entity dies at most once per refresh, so kill never has to allocate
+			deadIndices.reserve(newCapacity);
+			for (std::vector<u64>& v : versions)
+				v.resize((newCapacity + versionBlockSize() - 1) / versionBlockSize(), currentVersion);
+			enabledBits.resize((newCapacity + 63) / 64);
 
 			for (size_t i = capacity; i < newCapacity; ++i)
 				entities[i].alive = false;
@@ -45,7 +98,11 @@ namespace sxi::ecs::detail
 			if (capacity > newSize)
 				return;
 
-			reserve(2 * capacity);
+			// chunks keep existing components in place, so only one more is needed
+			if constexpr (TSettings::template isChunked<TArchetype>())
+				reserve(capacity + 1);
+			else
+				reserve(2 * capacity);
 		}
 
         [[nodiscard]] Entity<TArchetype>& entity(EntityIndex<TArchetype> index) noexcept
@@ -78,66 +135,363 @@ namespace sxi::ecs::detail
             return handleDatas[entity(index).handleDataIndex];
         }
 
-		void invalidateHandle(EntityIndex<TArchetype> index) noexcept
+		[[nodiscard]] bool hasHandle(EntityIndex<TArchetype> index) const noexcept
+		{
+			return entity(index).handleDataIndex != std::numeric_limits<size_t>::max();
+		}
+
+		void releaseHandle(EntityIndex<TArchetype> index)
+		{
+			if (!hasHandle(index))
+				return;
+
+			EntityHandleData<TArchetype>& data = entityHandleData(index);
+			if (data.alias != std::numeric_limits<size_t>::max())
+				releasedAliases.push_back(data.alias);
+			data.alias = std::numeric_limits<size_t>::max();
+
+			// bumping the counter invalidates every outstanding handle before the slot is reused
+			++data.counter;
+			freeHandleDatas.push_back(entity(index).handleDataIndex);
+			entity(index).handleDataIndex = std::numeric_limits<size_t>::max();
+		}
+
+		// the slot keeps its counter, so its handles stay tied to the entity wherever it moves
+		[[nodiscard]] EntityHandleDataIndex<TArchetype> detachHandle(EntityIndex<TArchetype> index) noexcept
 		{
-			++entityHandleData(index).counter;
+			EntityHandleDataIndex<TArchetype> slot = entity(index).handleDataIndex;
+			handleDatas[slot].index = std::numeric_limits<size_t>::max();
+			entity(index).handleDataIndex = std::numeric_limits<size_t>::max();
+			return slot;
 		}
 
 		void refreshHandle(EntityIndex<TArchetype> index) noexcept
 		{
-			entityHandleData(index).index = index;
+			if (hasHandle(index))
+				entityHandleData(index).index = index;
 		}
 
-		[[nodiscard]] size_t refreshImpl() noexcept
+		void setEnabledBit(size_t index, bool enabled) noexcept
 		{
-			EntityIndex<TArchetype> left{0}, right{newSize - 1};
-            while (true)
-            {
-                // go from left
-                while (true)
-                {
-                    if (left > right)
-                        return left;
-                    if (!entities[left].alive)
-                        break;
-                    ++left;
-                }
-                // go from right
-                while (true)
-                {
-                    if (left >= right)
-                        return left;
-                    if (entities[right].alive)
-                        break;
-					invalidateHandle(right);
-                    --right;
-                }
-
-                assert(!entities[left].alive);
-                assert(entities[right].alive);
-
-                std::swap(entities[left], entities[right]);
-				
-				refreshHandle(left);
-				invalidateHandle(right);
-				refreshHandle(right);
-
-				sxi::mpl::forTuple([left, right](auto& c){
-					std::swap(c[left], c[right]);
-				}, components);
-				++left;
-				--right;
-            }
-            return right;
+			u64 mask = u64{1} << (index % 64);
+			if (enabled)
+				enabledBits[index / 64] |= mask;
+			else
+				enabledBits[index / 64] &= ~mask;
+		}
+
+		void setEnabledBits(size_t begin, size_t end) noexcept
+		{
+			for (; begin < end && begin % 64 != 0; ++begin)
+				setEnabledBit(begin, true);
+			for (; begin + 64 <= end; begin += 64)
+				enabledBits[begin / 64] = ~u64{0};
+			for (; begin < end; ++begin)
+				setEnabledBit(begin, true);
+		}
+
+		[[nodiscard]] bool enabledBit(size_t index) const noexcept
+		{
+			return (enabledBits[index / 64] >> (index % 64)) & 1;
+		}
+
+		// calls func(runBegin, runEnd) for every maximal run of enabled entities in [begin, end)
+		template <typename Func>
+		void forEnabledRuns(size_t begin, size_t end, Func&& func) const
+		{
+			if (disabledCount == 0)
+			{
+				if (begin < end)
+					func(begin, end);
+				return;
+			}
+
+			size_t runBegin = begin;
+			bool inRun = false;
+			for (size_t i = begin; i < end;)
+			{
+				size_t bit = i % 64;
+				size_t available = std::min<size_t>(64 - bit, end - i);
+				u64 word = enabledBits[i / 64] >> bit;
+				if (!inRun)
+				{
+					size_t skipped = std::min<size_t>(std::countr_zero(word), available);
+					i += skipped;
+					if (skipped < available)
+					{
+						inRun = true;
+						runBegin = i;
+					}
+				}
+				else
+				{
+					size_t taken = std::min<size_t>(std::countr_one(word), available);
+					i += taken;
+					if (taken < available)
+					{
+						inRun = false;
+						func(runBegin, i);
+					}
+				}
+			}
+			if (inRun)
+				func(runBegin, end);
+		}
+
+		template <typename Func>
+		void forEnabled(size_t begin, size_t end, Func&& func) const
+		{
+			forEnabledRuns(begin, end, [&func](size_t runBegin, size_t runEnd){
+				for (EntityIndex<TArchetype> i{runBegin}; i < runEnd; ++i)
+					func(i);
+			});
+		}
+
+		void refreshImpl()
+		{
+			// removing from the back first guarantees the last entity is alive
+			// whenever a dead one is swapped with it
+			std::sort(deadIndices.begin(), deadIndices.end(), std::greater<size_t>{});
+			for (size_t deadIndex : deadIndices)
+			{
+				EntityIndex<TArchetype> dead{deadIndex}, last{newSize - 1};
+				assert(!entities[dead].alive);
+
+				releaseHandle(dead);
+				if (!enabledBit(dead))
+					--disabledCount;
+				if (dead != last)
+				{
+					assert(entities[last].alive);
+
+					std::swap(entities[dead], entities[last]);
+					components.swap(dead, last);
+					setEnabledBit(dead, enabledBit(last));
+					refreshHandle(dead);
+					stampAll(dead, dead + 1);
+				}
+				--newSize;
+			}
+			deadIndices.clear();
+		}
+
+		template <typename T>
+		void stamp(size_t begin, size_t end) noexcept
+		{
+			if constexpr (mpl::Contains<T, TrackedComponents>::value)
+			{
+				if (begin >= end)
+					return;
+
+				std::vector<u64>& v = versions[mpl::IndexOf<T, TrackedComponents>::value];
+				for (size_t block = begin / versionBlockSize(); block <= (end - 1) / versionBlockSize(); ++block)
+					v[block] = currentVersion;
+			}
+		}
+
+		void stampAll(size_t begin, size_t end) noexcept
+		{
+			mpl::forTypes<TrackedComponents>([this, begin, end](auto t){
+				stamp<SXI_MPL_TYPE(t)>(begin, end);
+			});
+		}
+
+		template <typename... Ts>
+		struct ExpandStampHelper
+		{
+			static void stamp(ArchetypeStorage<TSettings, TArchetype>& as, size_t begin, size_t end) noexcept
+			{
+				(as.template stamp<Ts>(begin, end), ...);
+			}
+		};
+
+		// only what the query hands out mutably, components in TReadList are plain reads
+		template <typename TSignature, typename TReadList>
+		void stampSignature(size_t begin, size_t end) noexcept
+		{
+			mpl::Rename<ExpandStampHelper, WrittenComponents<TSettings, TSignature, TReadList>>::stamp(*this, begin, end);
+		}
+
+		template <typename T>
+		void loadColumn(SnapshotReader& in, size_t count)
+		{
+			in.align();
+			const std::byte* source = in.take(count * sizeof(T));
+			for (size_t begin = 0, end; begin < count; begin = end)
+			{
+				end = components.contiguousEnd(begin, count);
+				std::memcpy(components.template data<T>(begin), source + begin * sizeof(T), (end - begin) * sizeof(T));
+			}
+		}
+
+		// a fold rather than mpl::forTypes, which is noexcept, so truncated files throw
+		template <typename... Ts>
+		struct ExpandLoadHelper
+		{
+			static void load(ArchetypeStorage<TSettings, TArchetype>& as, SnapshotReader& in, size_t count)
+			{
+				(as.template loadColumn<Ts>(in, count), ...);
+			}
+		};
+
+		template <typename TChangedList>
+		[[nodiscard]] bool changedSince(size_t block, u64 sinceVersion) const noexcept
+		{
+			bool changed = false;
+			mpl::forTypes<TChangedList>([this, block, sinceVersion, &changed](auto t){
+				using T = SXI_MPL_TYPE(t);
+				if constexpr (mpl::Contains<T, TrackedComponents>::value)
+					changed = changed || versions[mpl::IndexOf<T, TrackedComponents>::value][block] >= sinceVersion;
+			});
+			return changed;
+		}
+
+		template <typename T, size_t... Is>
+		[[nodiscard]] SplitReference<T> splitReference(size_t index, std::index_sequence<Is...>) noexcept
+		{
+			return SplitReference<T>({ &components.template get<FieldColumn<T, Is>>(index).value... });
+		}
+
+		template <typename T, size_t... Is>
+		[[nodiscard]] SplitReference<const T> splitReference(size_t index, std::index_sequence<Is...>) const noexcept
+		{
+			return SplitReference<const T>({ &components.template get<FieldColumn<T, Is>>(index).value... });
+		}
+
+		template <typename T, size_t... Is>
+		[[nodiscard]] SplitSpan<T> splitSpan(size_t begin, size_t end, std::index_sequence<Is...>) noexcept
+		{
+			return SplitSpan<T>({ &components.template get<FieldColumn<T, Is>>(begin).value... }, end - begin);
+		}
+
+		template <typename T, size_t... Is>
+		[[nodiscard]] SplitSpan<const T> splitSpan(size_t begin, size_t end, std::index_sequence<Is...>) const noexcept
+		{
+			return SplitSpan<const T>({ &components.template get<FieldColumn<T, Is>>(begin).value... }, end - begin);
+		}
+
+		// T& for regular components, a SplitReference for split ones and a pointer for Optional terms
+		template <typename T>
+		[[nodiscard]] decltype(auto) value(size_t index) noexcept
+		{
+			if constexpr (IsOptional<T>::value)
+			{
+				using U = Unwrapped<T>;
+				static_assert(!isSplitComponent<U>(), "Split components cannot be optional");
+				if constexpr (mpl::Contains<U, ArchetypeComponents>::value)
+					return &components.template get<U>(index);
+				else
+					return static_cast<U*>(nullptr);
+			}
+			else if constexpr (isSplitComponent<T>())
+				return splitReference<T>(index, std::make_index_sequence<SplitComponent<T>::fieldCount>{});
+			else
+				return components.template get<T>(index);
+		}
+
+		template <typename T>
+		[[nodiscard]] decltype(auto) value(size_t index) const noexcept
+		{
+			if constexpr (IsOptional<T>::value)
+			{
+				using U = Unwrapped<T>;
+				static_assert(!isSplitComponent<U>(), "Split components cannot be optional");
+				if constexpr (mpl::Contains<U, ArchetypeComponents>::value)
+					return &components.template get<U>(index);
+				else
+					return static_cast<const U*>(nullptr);
+			}
+			else if constexpr (isSplitComponent<T>())
+				return splitReference<T>(index, std::make_index_sequence<SplitComponent<T>::fieldCount>{});
+			else
+				return components.template get<T>(index);
+		}
+
+		// [begin, end) must not cross a contiguousEnd boundary
+		template <typename T>
+		[[nodiscard]] auto span(size_t begin, size_t end) noexcept
+		{
+			if constexpr (IsOptional<T>::value)
+			{
+				using U = Unwrapped<T>;
+				static_assert(!isSplitComponent<U>(), "Split components cannot be optional");
+				if constexpr (mpl::Contains<U, ArchetypeComponents>::value)
+					return std::span<U>(components.template data<U>(begin), end - begin);
+				else
+					return std::span<U>();
+			}
+			else if constexpr (isSplitComponent<T>())
+				return splitSpan<T>(begin, end, std::make_index_sequence<SplitComponent<T>::fieldCount>{});
+			else
+				return std::span<T>(components.template data<T>(begin), end - begin);
+		}
+
+		template <typename T>
+		[[nodiscard]] auto span(size_t begin, size_t end) const noexcept
+		{
+			if constexpr (IsOptional<T>::value)
+			{
+				using U = Unwrapped<T>;
+				static_assert(!isSplitComponent<U>(), "Split components cannot be optional");
+				if constexpr (mpl::Contains<U, ArchetypeComponents>::value)
+					return std::span<const U>(components.template data<U>(begin), end - begin);
+				else
+					return std::span<const U>();
+			}
+			else if constexpr (isSplitComponent<T>())
+				return splitSpan<T>(begin, end, std::make_index_sequence<SplitComponent<T>::fieldCount>{});
+			else
+				return std::span<const T>(components.template data<T>(begin), end - begin);
+		}
+
+		// components listed in TReadList are handed out const
+		template <typename T, typename TReadList>
+		[[nodiscard]] decltype(auto) access(size_t index) noexcept
+		{
+			if constexpr (mpl::Contains<Unwrapped<T>, TReadList>::value)
+				return std::as_const(*this).template value<T>(index);
+			else
+				return value<T>(index);
+		}
+
+		template <typename T, typename TReadList>
+		[[nodiscard]] auto accessSpan(size_t begin, size_t end) noexcept
+		{
+			if constexpr (mpl::Contains<Unwrapped<T>, TReadList>::value)
+				return std::as_const(*this).template span<T>(begin, end);
+			else
+				return span<T>(begin, end);
 		}
 
         template <typename... Ts>
         struct ExpandCallHelper
         {
-            template <typename Func>
+            template <typename TReadList, typename Func>
             static void call(EntityIndex<TArchetype> index, ArchetypeStorage<TSettings, TArchetype>& as, Func&& func)
             {
-                func(index, as.template component<Ts>(index)...);
+                func(index, as.template access<Ts, TReadList>(index)...);
+            }
+
+            template <typename Func>
+            static void call(EntityIndex<TArchetype> index, const ArchetypeStorage<TSettings, TArchetype>& as, Func&& func)
+            {
+                func(index, as.template value<Ts>(index)...);
+            }
+        };
+
+        template <typename... Ts>
+        struct ExpandChunkCallHelper
+        {
+            template <typename TReadList, typename Func>
+            static void call(size_t begin, size_t end, ArchetypeStorage<TSettings, TArchetype>& as, Func&& func)
+            {
+                func(EntityIndex<TArchetype>{begin}, as.template accessSpan<Ts, TReadList>(begin, end)...);
+            }
+
+            template <typename Func>
+            static void call(size_t begin, size_t end, const ArchetypeStorage<TSettings, TArchetype>& as, Func&& func)
+            {
+                func(EntityIndex<TArchetype>{begin}, as.template span<Ts>(begin, end)...);
             }
         };
 
@@ -149,6 +503,17 @@ namespace sxi::ecs::detail
 			reserve(initialCapacity);
 		}
 
+		void reserveAdditional(size_t count)
+		{
+			if (newSize + count <= capacity)
+				return;
+
+			if constexpr (TSettings::template isChunked<TArchetype>())
+				reserve(newSize + count);
+			else
+				reserve(std::max(newSize + count, 2 * capacity));
+		}
+
 		[[nodiscard]] EntityIndex<TArchetype> createEntity()
 		{
 			reserveIfNeeded();
@@ -159,39 +524,289 @@ namespace sxi::ecs::detail
 			assert(!e.alive);
 			e.handleDataIndex = std::numeric_limits<size_t>::max();
 			e.alive = true;
+			setEnabledBit(freeIndex, true);
+			stampAll(freeIndex, freeIndex + 1);
 
 			return freeIndex;
 		}
 
+		/**
+		 * @brief Creates count entities with a single reservation. They occupy
+		 * consecutive indices, so their components are contiguous in every column.
+		 */
+		[[nodiscard]] EntityRange<TArchetype> createEntities(size_t count)
+		{
+			reserveAdditional(count);
+
+			EntityRange<TArchetype> range{newSize, newSize + count};
+			for (size_t i = range.first; i < range.last; ++i)
+			{
+				Entity<TArchetype>& e = entities[i];
+				assert(!e.alive);
+				e.handleDataIndex = std::numeric_limits<size_t>::max();
+				e.alive = true;
+			}
+			setEnabledBits(range.first, range.last);
+			stampAll(range.first, range.last);
+			newSize = range.last;
+
+			return range;
+		}
+
+		/**
+		 * @brief Copies source[0, range.size()) into the component column of the range,
+		 * one memcpy per contiguous run.
+		 */
+		template <typename TComponent>
+		void copyComponents(const EntityRange<TArchetype>& range, const TComponent* source) noexcept
+		{
+			static_assert(std::is_trivially_copyable_v<TComponent>, "TComponent must be trivially copyable");
+
+			if constexpr (isSplitComponent<TComponent>())
+			{
+				for (size_t i = range.first; i < range.last; ++i)
+					value<TComponent>(i) = source[i - range.first];
+			}
+			else
+			{
+				for (size_t i = range.first; i < range.last;)
+				{
+					size_t runEnd = components.contiguousEnd(i, range.last);
+					std::memcpy(components.template data<TComponent>(i), source + (i - range.first), (runEnd - i) * sizeof(TComponent));
+					i = runEnd;
+				}
+			}
+			stamp<TComponent>(range.first, range.last);
+		}
+
 		[[nodiscard]] EntityHandle<TArchetype> createHandle(EntityIndex<TArchetype> index)
 		{
-			EntityHandleDataIndex<TArchetype> freeIndex{handleDatas.size()};
-			entity(index).handleDataIndex = freeIndex;
-            EntityHandleData<TArchetype> handleData;
-            handleData.index = index;
-            handleData.counter = 0;
-			handleDatas.push_back(handleData);
+			Entity<TArchetype>& e = entity(index);
+			if (!hasHandle(index))
+			{
+				if (freeHandleDatas.empty())
+				{
+					e.handleDataIndex = handleDatas.size();
+					handleDatas.emplace_back();
+					handleDatas.back().counter = 0;
+				}
+				else
+				{
+					e.handleDataIndex = freeHandleDatas.back();
+					freeHandleDatas.pop_back();
+				}
+				entityHandleData(index).index = index;
+			}
+
             EntityHandle<TArchetype> handle;
-            handle.handleDataIndex = freeIndex;
-            handle.counter = 0;
+            handle.handleDataIndex = e.handleDataIndex;
+            handle.counter = entityHandleData(index).counter;
 			return handle;
 		}
 
 		[[nodiscard]] bool isEntityHandleValid(const EntityHandle<TArchetype>& handle) const noexcept
 		{
-			return entityHandleData(handle).counter == handle.counter;
+			// handles kept in components survive snapshots, which may leave them past the table
+			if (handle.handleDataIndex >= handleDatas.size())
+				return false;
+
+			const EntityHandleData<TArchetype>& data = entityHandleData(handle);
+			// slots of entities that migrated elsewhere keep their counter but have no entity here
+			return data.counter == handle.counter && data.index != std::numeric_limits<size_t>::max();
+		}
+
+		[[nodiscard]] EntityIndex<TArchetype> entityIndex(const EntityHandle<TArchetype>& handle) const noexcept
+		{
+			assert(isEntityHandleValid(handle));
+			return entityHandleData(handle).index;
+		}
+
+		template <typename TChangedList>
+		[[nodiscard]] bool entityChangedSince(EntityIndex<TArchetype> index, u64 sinceVersion) const noexcept
+		{
+			return changedSince<TChangedList>(index / versionBlockSize(), sinceVersion);
+		}
+
+		template <typename TChangedList, typename Func>
+		void forIndicesChanged(u64 sinceVersion, Func&& func) const
+		{
+			for (size_t begin = 0; begin < size; begin += versionBlockSize())
+			{
+				if (!changedSince<TChangedList>(begin / versionBlockSize(), sinceVersion))
+					continue;
+
+				size_t end = std::min(begin + versionBlockSize(), size);
+				for (EntityIndex<TArchetype> i{begin}; i < end; ++i)
+					func(i);
+			}
+		}
+
+		[[nodiscard]] size_t entityCount() const noexcept
+		{
+			return size;
+		}
+
+		/**
+		 * @brief Alias of the slot a handle refers to, max() when the handle is
+		 * stale or its entity never migrated.
+		 */
+		[[nodiscard]] size_t handleAlias(const EntityHandle<TArchetype>& handle) const noexcept
+		{
+			if (handle.handleDataIndex >= handleDatas.size() || entityHandleData(handle).counter != handle.counter)
+				return std::numeric_limits<size_t>::max();
+			return entityHandleData(handle).alias;
+		}
+
+		[[nodiscard]] size_t handleAlias(EntityHandleDataIndex<TArchetype> slot) const noexcept
+		{
+			return handleDatas[slot].alias;
+		}
+
+		void setHandleAlias(EntityHandleDataIndex<TArchetype> slot, size_t alias) noexcept
+		{
+			handleDatas[slot].alias = alias;
+		}
+
+		/**
+		 * @brief Handle to a slot, which is valid only while an entity of this
+		 * archetype holds it. max() gives an invalid handle.
+		 */
+		[[nodiscard]] EntityHandle<TArchetype> handleTo(EntityHandleDataIndex<TArchetype> slot) const noexcept
+		{
+			EntityHandle<TArchetype> handle;
+			handle.handleDataIndex = slot;
+			handle.counter = slot < handleDatas.size() ? handleDatas[slot].counter : 0;
+			return handle;
+		}
+
+		/**
+		 * @brief Takes a slot without an entity, attached to one later on by adopt.
+		 */
+		[[nodiscard]] EntityHandleDataIndex<TArchetype> reserveHandleSlot()
+		{
+			EntityHandleDataIndex<TArchetype> slot;
+			if (freeHandleDatas.empty())
+			{
+				slot = handleDatas.size();
+				handleDatas.emplace_back();
+				handleDatas.back().counter = 0;
+			}
+			else
+			{
+				slot = freeHandleDatas.back();
+				freeHandleDatas.pop_back();
+			}
+			handleDatas[slot].index = std::numeric_limits<size_t>::max();
+			return slot;
+		}
+
+		/**
+		 * @brief Frees a slot no entity of this archetype holds, invalidating its handles.
+		 */
+		void releaseHandleSlot(EntityHandleDataIndex<TArchetype> slot)
+		{
+			++handleDatas[slot].counter;
+			handleDatas[slot].alias = std::numeric_limits<size_t>::max();
+			freeHandleDatas.push_back(slot);
+		}
+
+		[[nodiscard]] std::vector<size_t>& releasedHandleAliases() noexcept
+		{
+			return releasedAliases;
+		}
+
+		/**
+		 * @brief Moves entities out of another archetype into new entities of this one.
+		 *
+		 * Components both archetypes share are moved column by column, contiguous
+		 * runs of trivially copyable ones with a single memcpy, everything else is
+		 * default initialised. The source entities are killed. A source's handle
+		 * slot is detached from it with its counter intact and passed to
+		 * forwardSlot(slot), whose result is attached to the new entity. Sources
+		 * that are already dead are skipped.
+		 */
+		template <typename TOther, typename Func>
+		void adopt(ArchetypeStorage<TSettings, TOther>& from, std::vector<EntityIndex<TOther>>& sources, Func&& forwardSlot)
+		{
+			// drop dead and duplicate sources first so each survivor is moved exactly once
+			size_t count = 0;
+			for (EntityIndex<TOther> index : sources)
+			{
+				if (!from.isAlive(index))
+					continue;
+
+				from.kill(index);
+				sources[count++] = index;
+			}
+			sources.resize(count);
+			if (count == 0)
+				return;
+
+			// ascending sources turn neighbours into runs a column can copy at once
+			std::sort(sources.begin(), sources.end());
+
+			size_t first = createEntities(count).first;
+			for (size_t k = 0; k < count; ++k)
+			{
+				EntityIndex<TArchetype> index{first + k};
+				setEnabled(index, from.isEnabled(sources[k]));
+
+				if (!from.hasHandle(sources[k]))
+					continue;
+
+				EntityHandleDataIndex<TArchetype> slot = forwardSlot(from.detachHandle(sources[k]));
+				entity(index).handleDataIndex = slot;
+				handleDatas[slot].index = index;
+			}
+
+			using Shared = mpl::Filter<mpl::ContainedIn<typename ArchetypeStorage<TSettings, TOther>::StoredComponents>::template Filter, StoredComponents>;
+			mpl::forTypes<Shared>([this, &from, &sources, first, count](auto t){
+				using T = SXI_MPL_TYPE(t);
+				for (size_t k = 0; k < count;)
+				{
+					size_t source = sources[k];
+					size_t end = components.contiguousEnd(first + k, first + count) - first;
+					end = k + (from.components.contiguousEnd(source, source + (end - k)) - source);
+					size_t runEnd = k + 1;
+					while (runEnd < end && sources[runEnd] == source + (runEnd - k))
+						++runEnd;
+
+					T* target = components.template data<T>(first + k);
+					T* moved = from.components.template data<T>(source);
+					if constexpr (std::is_trivially_copyable_v<T>)
+						std::memcpy(target, moved, (runEnd - k) * sizeof(T));
+					else
+						std::move(moved, moved + (runEnd - k), target);
+					k = runEnd;
+				}
+			});
+		}
+
+		template <typename TComponent>
+		[[nodiscard]] decltype(auto) component(EntityIndex<TArchetype> index) noexcept
+		{
+			stamp<TComponent>(index, index + 1);
+			return value<TComponent>(index);
+		}
+
+		template <typename TComponent>
+		[[nodiscard]] decltype(auto) component(EntityIndex<TArchetype> index) const noexcept
+		{
+			return value<TComponent>(index);
 		}
 
 		template <typename TComponent>
-		[[nodiscard]] TComponent& component(EntityIndex<TArchetype> index) noexcept
+		[[nodiscard]] decltype(auto) component(const EntityHandle<TArchetype>& handle) noexcept
 		{
-			return std::get<std::vector<TComponent>>(components)[index];
+			assert(isEntityHandleValid(handle));
+			return component<TComponent>(entityHandleData(handle).index);
 		}
 
 		template <typename TComponent>
-		[[nodiscard]] const TComponent& component(EntityIndex<TArchetype> index) const noexcept
+		[[nodiscard]] decltype(auto) component(const EntityHandle<TArchetype>& handle) const noexcept
 		{
-			return std::get<std::vector<TComponent>>(components)[index];
+			assert(isEntityHandleValid(handle));
+			return component<TComponent>(entityHandleData(handle).index);
 		}
 
 		bool isAlive(EntityIndex<TArchetype> index) const noexcept
@@ -199,30 +814,236 @@ namespace sxi::ecs::detail
 			return entity(index).alive;
 		}
 
+		bool isEnabled(EntityIndex<TArchetype> index) const noexcept
+		{
+			return enabledBit(index);
+		}
+
+		void setEnabled(EntityIndex<TArchetype> index, bool enabled) noexcept
+		{
+			if (enabledBit(index) == enabled)
+				return;
+
+			setEnabledBit(index, enabled);
+			if (enabled)
+				--disabledCount;
+			else
+				++disabledCount;
+		}
+
 		void kill(EntityIndex<TArchetype> index) noexcept
 		{
-			entity(index).alive = false;
+			Entity<TArchetype>& e = entity(index);
+			if (!e.alive)
+				return;
+
+			e.alive = false;
+			deadIndices.push_back(index);
 		}
 
 		bool isAlive(const EntityHandle<TArchetype>& handle) const noexcept
 		{
-			return entity(entityHandleData(handle).index).alive;
+			return isEntityHandleValid(handle) && entity(entityHandleData(handle).index).alive;
 		}
 
 		void kill(const EntityHandle<TArchetype>& handle) noexcept
 		{
-			entity(entityHandleData(handle).index).alive = false;
+			if (isEntityHandleValid(handle))
+				kill(entityHandleData(handle).index);
+		}
+
+		void swapEntities(size_t a, size_t b) noexcept
+		{
+			std::swap(entities[a], entities[b]);
+			components.swap(a, b);
+			bool enabledA = enabledBit(a);
+			setEnabledBit(a, enabledBit(b));
+			setEnabledBit(b, enabledA);
+			refreshHandle(EntityIndex<TArchetype>{a});
+			refreshHandle(EntityIndex<TArchetype>{b});
 		}
 
-		void refresh() noexcept
+		/**
+		 * @brief Reorders the refreshed entities by keyFunc(const TKeyComponents&...),
+		 * moving every column together and patching handles.
+		 *
+		 * Ascending runs are detected and merged (natural merge sort), so already or
+		 * nearly sorted storage costs little more than computing the keys. The sort is
+		 * stable. Indices held by the caller are invalidated, handles stay valid.
+		 */
+		template <typename... TKeyComponents, typename Func>
+		void sortBy(Func&& keyFunc)
 		{
-			if (newSize == 0)
+			auto keyOf = [this, &keyFunc](size_t i){
+				return keyFunc(std::as_const(*this).template value<TKeyComponents>(i)...);
+			};
+			using Key = decltype(keyOf(size_t{}));
+
+			std::vector<Key> keys;
+			keys.reserve(size);
+			std::vector<size_t> runEnds;
+			for (size_t i = 0; i < size; ++i)
 			{
-				size = 0;
+				keys.push_back(keyOf(i));
+				if (i > 0 && keys[i] < keys[i - 1])
+					runEnds.push_back(i);
+			}
+			if (runEnds.empty())
 				return;
+			runEnds.push_back(size);
+
+			// order[i] is the current index of the entity that belongs at i
+			std::vector<size_t> order(size);
+			std::iota(order.begin(), order.end(), size_t{0});
+			auto byKey = [&keys](size_t a, size_t b){ return keys[a] < keys[b]; };
+			while (runEnds.size() > 1)
+			{
+				size_t merged = 0;
+				for (size_t k = 0, begin = 0; k < runEnds.size(); k += 2)
+				{
+					if (k + 1 < runEnds.size())
+						std::inplace_merge(order.begin() + begin, order.begin() + runEnds[k], order.begin() + runEnds[k + 1], byKey);
+					begin = runEnds[std::min(k + 1, runEnds.size() - 1)];
+					runEnds[merged++] = begin;
+				}
+				runEnds.resize(merged);
+			}
+
+			size_t first = size, last = 0;
+			for (size_t i = 0; i < size; ++i)
+			{
+				if (order[i] == i)
+					continue;
+
+				first = std::min(first, i);
+				last = std::max(last, i);
+				size_t current = i;
+				while (order[current] != i)
+				{
+					size_t next = order[current];
+					swapEntities(current, next);
+					order[current] = current;
+					current = next;
+					last = std::max(last, current);
+				}
+				order[current] = current;
+			}
+			stampAll(first, last + 1);
+
+			// kills recorded before the sort point at old indices
+			if (!deadIndices.empty())
+			{
+				deadIndices.clear();
+				for (size_t i = 0; i < newSize; ++i)
+					if (!entities[i].alive)
+						deadIndices.push_back(i);
+			}
+		}
+
+		static constexpr u64 layoutHash(u64 hash) noexcept
+		{
+			hash = hashCombine(hash, mpl::Count<StoredComponents>::value);
+			mpl::forTypes<StoredComponents>([&hash](auto t){
+				using T = SXI_MPL_TYPE(t);
+				hash = hashCombine(hash, sizeof(T));
+				hash = hashCombine(hash, alignof(T));
+			});
+			return hash;
+		}
+
+		/**
+		 * @brief Writes the refreshed entities' enable bits and components, one
+		 * aligned block per column. Entities created or killed since the last
+		 * refresh are not part of it.
+		 */
+		void save(SnapshotWriter& out) const
+		{
+			out.write(u64{size});
+			for (size_t word = 0; word < (size + 63) / 64; ++word)
+			{
+				u64 bits = enabledBits[word];
+				if (word == size / 64)
+					bits &= (u64{1} << (size % 64)) - 1;
+				out.write(bits);
 			}
 
-			size = newSize = refreshImpl();
+			mpl::forTypes<StoredComponents>([this, &out](auto t){
+				using T = SXI_MPL_TYPE(t);
+				static_assert(std::is_trivially_copyable_v<T>, "Snapshots require trivially copyable components");
+
+				out.align();
+				for (size_t begin = 0, end; begin < size; begin = end)
+				{
+					end = components.contiguousEnd(begin, size);
+					out.write(components.template data<T>(begin), (end - begin) * sizeof(T));
+				}
+			});
+		}
+
+		static constexpr size_t entityBytes() noexcept
+		{
+			size_t bytes = 0;
+			mpl::forTypes<StoredComponents>([&bytes](auto t){
+				bytes += sizeof(SXI_MPL_TYPE(t));
+			});
+			return bytes;
+		}
+
+		/**
+		 * @brief Reads the entities of a snapshot into this freshly constructed
+		 * storage. Columns are memcpy'd straight out of the (mapped) file.
+		 */
+		void load(SnapshotReader& in, u64 version)
+		{
+			assert(newSize == 0 && handleDatas.empty());
+			currentVersion = version;
+
+			size_t count = in.template read<u64>();
+			// a corrupt count has to fail here rather than in a huge allocation
+			size_t words = count / 64 + (count % 64 != 0);
+			if (words > in.remaining() / sizeof(u64) ||
+				(entityBytes() > 0 && count > (in.remaining() - words * sizeof(u64)) / entityBytes()))
+				throw InvalidArgumentException("Corrupt snapshot file");
+
+			(void)createEntities(count);
+			for (size_t word = 0; word < (count + 63) / 64; ++word)
+				enabledBits[word] = in.template read<u64>();
+			for (size_t word = 0; word < (count + 63) / 64; ++word)
+				disabledCount += std::min<size_t>(64, count - 64 * word) - std::popcount(enabledBits[word]);
+
+			mpl::Rename<ExpandLoadHelper, StoredComponents>::load(*this, in, count);
+			size = newSize;
+		}
+
+		/**
+		 * @brief Takes over the entities of a storage filled by load but keeps this
+		 * storage's handle table. Every slot's counter is bumped and the slot freed,
+		 * so existing handles report dead instead of aliasing loaded entities.
+		 */
+		void replaceWith(ArchetypeStorage&& loaded)
+		{
+			std::vector<EntityHandleData<TArchetype>> kept = std::move(handleDatas);
+			*this = std::move(loaded);
+			handleDatas = std::move(kept);
+
+			freeHandleDatas.clear();
+			freeHandleDatas.reserve(handleDatas.size());
+			for (size_t slot = handleDatas.size(); slot-- > 0;)
+			{
+				++handleDatas[slot].counter;
+				handleDatas[slot].index = std::numeric_limits<size_t>::max();
+				handleDatas[slot].alias = std::numeric_limits<size_t>::max();
+				freeHandleDatas.push_back(EntityHandleDataIndex<TArchetype>{slot});
+			}
+		}
+
+		void refresh(u64 nextVersion)
+		{
+			if (!deadIndices.empty())
+				refreshImpl();
+
+			size = newSize;
+			currentVersion = nextVersion;
 		}
         
         template <typename Func>
@@ -232,15 +1053,126 @@ namespace sxi::ecs::detail
 				func(i);
         }
         
-        template <typename TSignature, typename Func>
+        template <typename TSignature, typename TReadList, typename Func>
         void forComponents(Func&& func)
         {	
-			if constexpr(mpl::IsSubset<TArchetype, TSignature>::value)
+			if constexpr(matches<TArchetype, TSignature>())
+			{	
+				using RequiredComponents = QueryComponents<TSettings, TSignature>;
+				using Helper = mpl::Rename<ExpandCallHelper, RequiredComponents>;
+				stampSignature<TSignature, TReadList>(0, size);
+				forEnabled(0, size, [this, &func](EntityIndex<TArchetype> i){
+					Helper::template call<TReadList>(i, *this, func);
+				});
+			}
+        }
+
+        template <typename TSignature, typename Func>
+        void forComponents(Func&& func) const
+        {	
+			if constexpr(matches<TArchetype, TSignature>())
 			{	
-				using RequiredComponents = mpl::Filter<TSettings::template IsComponentFilter, TSignature>;
+				using RequiredComponents = QueryComponents<TSettings, TSignature>;
 				using Helper = mpl::Rename<ExpandCallHelper, RequiredComponents>;
-				for (EntityIndex<TArchetype> i{0}; i < size; ++i)
+				forEnabled(0, size, [this, &func](EntityIndex<TArchetype> i){
 					Helper::call(i, *this, func);
+				});
+			}
+        }
+
+        template <typename TSignature, typename TChangedList, typename Func>
+        void forChangedComponents(u64 sinceVersion, Func&& func) const
+        {
+			if constexpr(matches<TArchetype, TSignature>())
+			{
+				using RequiredComponents = QueryComponents<TSettings, TSignature>;
+				using Helper = mpl::Rename<ExpandCallHelper, RequiredComponents>;
+				for (size_t begin = 0; begin < size; begin += versionBlockSize())
+				{
+					if (!changedSince<TChangedList>(begin / versionBlockSize(), sinceVersion))
+						continue;
+
+					size_t end = std::min(begin + versionBlockSize(), size);
+					forEnabled(begin, end, [this, &func](EntityIndex<TArchetype> i){
+						Helper::call(i, *this, func);
+					});
+				}
+			}
+        }
+
+        template <typename TSignature, typename TReadList, typename Func>
+        void forChunks(Func&& func)
+        {
+			if constexpr(matches<TArchetype, TSignature>())
+			{
+				using RequiredComponents = QueryComponents<TSettings, TSignature>;
+				using Helper = mpl::Rename<ExpandChunkCallHelper, RequiredComponents>;
+				stampSignature<TSignature, TReadList>(0, size);
+				for (size_t begin = 0, end; begin < size; begin = end)
+				{
+					end = components.contiguousEnd(begin, size);
+					forEnabledRuns(begin, end, [this, &func](size_t runBegin, size_t runEnd){
+						Helper::template call<TReadList>(runBegin, runEnd, *this, func);
+					});
+				}
+			}
+        }
+
+        template <typename TSignature, typename Func>
+        void forChunks(Func&& func) const
+        {
+			if constexpr(matches<TArchetype, TSignature>())
+			{
+				using RequiredComponents = QueryComponents<TSettings, TSignature>;
+				using Helper = mpl::Rename<ExpandChunkCallHelper, RequiredComponents>;
+				for (size_t begin = 0, end; begin < size; begin = end)
+				{
+					end = components.contiguousEnd(begin, size);
+					forEnabledRuns(begin, end, [this, &func](size_t runBegin, size_t runEnd){
+						Helper::call(runBegin, runEnd, *this, func);
+					});
+				}
+			}
+        }
+
+        template <typename TSignature, typename TReadList, typename Func>
+        void forChunksParallel(jobs::ThreadPool& pool, jobs::JobCounter& counter, Func& func, size_t grainSize)
+        {
+			if constexpr(matches<TArchetype, TSignature>())
+			{
+				using RequiredComponents = QueryComponents<TSettings, TSignature>;
+				using Helper = mpl::Rename<ExpandChunkCallHelper, RequiredComponents>;
+				// stamped up front so jobs never write the shared version blocks
+				stampSignature<TSignature, TReadList>(0, size);
+				for (size_t begin = 0, end; begin < size; begin = end)
+				{
+					end = std::min(components.contiguousEnd(begin, size), begin + grainSize);
+					pool.submit([this, &func, begin, end](){
+						forEnabledRuns(begin, end, [this, &func](size_t runBegin, size_t runEnd){
+							Helper::template call<TReadList>(runBegin, runEnd, *this, func);
+						});
+					}, &counter);
+				}
+			}
+        }
+
+        template <typename TSignature, typename TReadList, typename Func>
+        void forComponentsParallel(jobs::ThreadPool& pool, jobs::JobCounter& counter, Func& func, size_t grainSize)
+        {
+			if constexpr(matches<TArchetype, TSignature>())
+			{
+				using RequiredComponents = QueryComponents<TSettings, TSignature>;
+				using Helper = mpl::Rename<ExpandCallHelper, RequiredComponents>;
+				stampSignature<TSignature, TReadList>(0, size);
+				for (size_t begin = 0; begin < size; begin += grainSize)
+				{
+					size_t end = std::min(begin + grainSize, size);
+					pool.submit([this, &func, begin, end](){
+						forEnabled(begin, end, [this, &func](EntityIndex<TArchetype> i){
+							Helper::template call<TReadList>(i, *this, func);
+						});
+					}, &counter);
+				}
 			}
         }
 	};
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <stddef.h>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "../../MPL/TypeList.h"
+#include "../../MPL/IndexOf.h"
+
+namespace sxi::ecs::detail
+{
+    inline constexpr size_t CHUNK_BYTES = 16 * 1024;
+    inline constexpr size_t CHUNK_ALIGNMENT = 64;
+
+    /**
+     * @brief Component columns split into fixed-size chunks.
+     *
+     * Every chunk is an aligned block holding entitiesPerChunk entities laid out
+     * column by column, each column starting on its own cache line, or on
+     * TAllocator's alignment when that is larger. Growing only allocates new
+     * chunks, so existing components are never copied and references to them
+     * stay valid.
+     */
+    template <typename TAllocator, typename TComponentList>
+    class ChunkedColumns;
+
+    template <typename TAllocator, typename... Ts>
+    class ChunkedColumns<TAllocator, sxi::mpl::typelist<Ts...>> final
+    {
+        static constexpr size_t alignment = std::max(CHUNK_ALIGNMENT, TAllocator::alignment);
+        static constexpr size_t columnCount = sizeof...(Ts);
+        static constexpr size_t rowBytes = (sizeof(Ts) + ... + 0);
+
+        static constexpr size_t alignUp(size_t bytes) noexcept
+        {
+            return (bytes + alignment - 1) / alignment * alignment;
+        }
+
+        // column padding comes out of the chunk, but never more than half of it, so
+        // large alignments or many columns grow the chunk instead of emptying it
+        static constexpr size_t paddingBytes = std::min(alignment * columnCount, CHUNK_BYTES / 2);
+
+    public:
+        static constexpr size_t entitiesPerChunk = rowBytes == 0 ? CHUNK_BYTES :
+            std::max<size_t>(1, (CHUNK_BYTES - paddingBytes) / rowBytes);
+
+    private:
+        static constexpr std::array<size_t, columnCount + 1> offsets = [](){
+            std::array<size_t, columnCount> sizes{ sizeof(Ts)... };
+            std::array<size_t, columnCount + 1> result{};
+            for (size_t i = 0; i < columnCount; ++i)
+                result[i + 1] = result[i] + alignUp(sizes[i] * entitiesPerChunk);
+            return result;
+        }();
+        static constexpr size_t chunkBytes = std::max<size_t>(offsets[columnCount], alignment);
+
+        template <typename T>
+        static constexpr size_t offset() noexcept
+        {
+            return offsets[sxi::mpl::IndexOf<T, sxi::mpl::typelist<Ts...>>::value];
+        }
+
+        template <typename T>
+        [[nodiscard]] static T* column(std::byte* chunk) noexcept
+        {
+            return std::launder(reinterpret_cast<T*>(chunk + offset<T>()));
+        }
+
+        std::vector<std::byte*> chunks;
+
+        [[nodiscard]] static std::byte* allocateChunk()
+        {
+            std::byte* chunk = static_cast<std::byte*>(::operator new(chunkBytes, std::align_val_t{alignment}));
+            (std::uninitialized_value_construct_n(reinterpret_cast<Ts*>(chunk + offset<Ts>()), entitiesPerChunk), ...);
+            return chunk;
+        }
+
+        static void freeChunk(std::byte* chunk) noexcept
+        {
+            (std::destroy_n(column<Ts>(chunk), entitiesPerChunk), ...);
+            ::operator delete(chunk, std::align_val_t{alignment});
+        }
+
+        void clear() noexcept
+        {
+            for (std::byte* chunk : chunks)
+                freeChunk(chunk);
+            chunks.clear();
+        }
+
+    public:
+        ChunkedColumns() = default;
+
+        ChunkedColumns(const ChunkedColumns& other)
+        {
+            *this = other;
+        }
+
+        ChunkedColumns(ChunkedColumns&& other) noexcept : chunks(std::move(other.chunks))
+        {
+            other.chunks.clear();
+        }
+
+        ChunkedColumns& operator=(const ChunkedColumns& other)
+        {
+            if (this == &other)
+                return *this;
+
+            reserve(other.capacity());
+            for (size_t i = 0; i < other.chunks.size(); ++i)
+                (std::copy_n(column<Ts>(other.chunks[i]), entitiesPerChunk, column<Ts>(chunks[i])), ...);
+            return *this;
+        }
+
+        ChunkedColumns& operator=(ChunkedColumns&& other) noexcept
+        {
+            if (this == &other)
+                return *this;
+
+            clear();
+            chunks = std::move(other.chunks);
+            other.chunks.clear();
+            return *this;
+        }
+
+        ~ChunkedColumns()
+        {
+            clear();
+        }
+
+        void reserve(size_t newCapacity)
+        {
+            size_t chunkCount = (newCapacity + entitiesPerChunk - 1) / entitiesPerChunk;
+            chunks.reserve(chunkCount);
+            while (chunks.size() < chunkCount)
+                chunks.push_back(allocateChunk());
+        }
+
+        [[nodiscard]] size_t capacity() const noexcept
+        {
+            return chunks.size() * entitiesPerChunk;
+        }
+
+        template <typename T>
+        [[nodiscard]] T& get(size_t index) noexcept
+        {
+            return column<T>(chunks[index / entitiesPerChunk])[index % entitiesPerChunk];
+        }
+
+        template <typename T>
+        [[nodiscard]] const T& get(size_t index) const noexcept
+        {
+            return column<T>(chunks[index / entitiesPerChunk])[index % entitiesPerChunk];
+        }
+
+        template <typename T>
+        [[nodiscard]] T* data(size_t index) noexcept
+        {
+            return &get<T>(index);
+        }
+
+        template <typename T>
+        [[nodiscard]] const T* data(size_t index) const noexcept
+        {
+            return &get<T>(index);
+        }
+
+        void swap(size_t a, size_t b) noexcept
+        {
+            using std::swap;
+            (swap(get<Ts>(a), get<Ts>(b)), ...);
+        }
+
+        [[nodiscard]] size_t contiguousEnd(size_t index, size_t end) const noexcept
+        {
+            return std::min(end, (index / entitiesPerChunk + 1) * entitiesPerChunk);
+        }
+    };
+}
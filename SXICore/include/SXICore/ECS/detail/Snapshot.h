@@ -0,0 +1,118 @@
+#pragma once
+
+#include <stddef.h>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <type_traits>
+
+#include "../../Exception.h"
+#include "../../Types.h"
+
+namespace sxi::ecs::detail
+{
+    inline constexpr u32 SNAPSHOT_MAGIC = 0x57495853; // "SXIW"
+    inline constexpr u32 SNAPSHOT_VERSION = 1;
+    // columns start on this boundary in the file so mapped columns are aligned too
+    inline constexpr size_t SNAPSHOT_ALIGNMENT = 64;
+
+    struct SnapshotHeader final
+    {
+        u32 magic;
+        u32 formatVersion;
+        u64 layoutHash;
+        u64 worldVersion;
+    };
+
+    // FNV-1a step, used to fingerprint the component layout a snapshot was written with
+    constexpr u64 hashCombine(u64 hash, u64 value) noexcept
+    {
+        for (size_t i = 0; i < sizeof(u64); ++i)
+        {
+            hash ^= (value >> (8 * i)) & 0xff;
+            hash *= 0x100000001b3;
+        }
+        return hash;
+    }
+
+    class SnapshotWriter final
+    {
+        std::ofstream file;
+        size_t offset{};
+
+    public:
+        explicit SnapshotWriter(const std::string& path) : file(path, std::ios::binary | std::ios::trunc)
+        {
+            if (!file.is_open())
+                throw InvalidArgumentException("Failed to open snapshot file");
+        }
+
+        void write(const void* data, size_t bytes)
+        {
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+            offset += bytes;
+        }
+
+        template <typename T>
+        void write(const T& value)
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            write(&value, sizeof(T));
+        }
+
+        void align()
+        {
+            static constexpr char zeros[SNAPSHOT_ALIGNMENT]{};
+            write(zeros, (SNAPSHOT_ALIGNMENT - offset % SNAPSHOT_ALIGNMENT) % SNAPSHOT_ALIGNMENT);
+        }
+
+        void finish()
+        {
+            file.flush();
+            if (!file)
+                throw ResourceCreationException("Failed to write snapshot file");
+        }
+    };
+
+    class SnapshotReader final
+    {
+        const std::byte* begin;
+        const std::byte* cursor;
+        const std::byte* end;
+
+    public:
+        SnapshotReader(const std::byte* data, size_t bytes) noexcept : begin(data), cursor(data), end(data + bytes) {}
+
+        [[nodiscard]] size_t remaining() const noexcept
+        {
+            return static_cast<size_t>(end - cursor);
+        }
+
+        // returns a pointer to the next bytes bytes of the file and skips them
+        [[nodiscard]] const std::byte* take(size_t bytes)
+        {
+            if (remaining() < bytes)
+                throw InvalidArgumentException("Truncated snapshot file");
+
+            const std::byte* data = cursor;
+            cursor += bytes;
+            return data;
+        }
+
+        template <typename T>
+        [[nodiscard]] T read()
+        {
+            static_assert(std::is_trivially_copyable_v<T>);
+            T value;
+            std::memcpy(&value, take(sizeof(T)), sizeof(T));
+            return value;
+        }
+
+        void align()
+        {
+            size_t offset = static_cast<size_t>(cursor - begin);
+            (void)take((SNAPSHOT_ALIGNMENT - offset % SNAPSHOT_ALIGNMENT) % SNAPSHOT_ALIGNMENT);
+        }
+    };
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <stddef.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#include "../../MPL/TypeList.h"
+#include "../../MPL/TypeListOperations.h"
+
+namespace sxi::ecs::detail
+{
+    /**
+     * @brief Growable array of components whose memory comes from TAllocator.
+     */
+    template <typename T, typename TAllocator>
+    class AlignedColumn final
+    {
+        static_assert(alignof(T) <= TAllocator::alignment, "The column allocator alignment is too small for T");
+
+        T* elements = nullptr;
+        size_t cap{};
+
+        [[nodiscard]] static size_t bytesFor(size_t capacity) noexcept
+        {
+            return TAllocator::allocationBytes(capacity * sizeof(T));
+        }
+
+        void release() noexcept
+        {
+            if (!elements)
+                return;
+
+            std::destroy_n(elements, cap);
+            TAllocator::deallocate(elements, bytesFor(cap));
+            elements = nullptr;
+            cap = 0;
+        }
+
+    public:
+        AlignedColumn() = default;
+
+        AlignedColumn(const AlignedColumn& other)
+        {
+            reserve(other.cap);
+            std::copy_n(other.elements, cap, elements);
+        }
+
+        AlignedColumn(AlignedColumn&& other) noexcept
+            : elements(std::exchange(other.elements, nullptr)), cap(std::exchange(other.cap, 0))
+        {
+        }
+
+        AlignedColumn& operator=(AlignedColumn other) noexcept
+        {
+            std::swap(elements, other.elements);
+            std::swap(cap, other.cap);
+            return *this;
+        }
+
+        ~AlignedColumn()
+        {
+            release();
+        }
+
+        void reserve(size_t newCapacity)
+        {
+            if (newCapacity <= cap)
+                return;
+
+            size_t bytes = bytesFor(newCapacity);
+            T* grown = static_cast<T*>(TAllocator::allocate(bytes));
+            std::uninitialized_move_n(elements, cap, grown);
+            std::uninitialized_value_construct_n(grown + cap, newCapacity - cap);
+            std::memset(reinterpret_cast<std::byte*>(grown + newCapacity), 0, bytes - newCapacity * sizeof(T));
+
+            release();
+            elements = grown;
+            cap = newCapacity;
+        }
+
+        [[nodiscard]] T& operator[](size_t index) noexcept
+        {
+            return elements[index];
+        }
+
+        [[nodiscard]] const T& operator[](size_t index) const noexcept
+        {
+            return elements[index];
+        }
+
+        [[nodiscard]] T* data() noexcept
+        {
+            return elements;
+        }
+
+        [[nodiscard]] const T* data() const noexcept
+        {
+            return elements;
+        }
+    };
+
+    template <typename TAllocator, typename TComponentList>
+    class VectorColumns;
+
+    template <typename TAllocator, typename... Ts>
+    class VectorColumns<TAllocator, sxi::mpl::typelist<Ts...>> final
+    {
+        std::tuple<AlignedColumn<Ts, TAllocator>...> columns;
+        size_t cap{};
+
+    public:
+        void reserve(size_t newCapacity)
+        {
+            sxi::mpl::forTuple([newCapacity](auto& c){
+                c.reserve(newCapacity);
+            }, columns);
+            cap = std::max(cap, newCapacity);
+        }
+
+        [[nodiscard]] size_t capacity() const noexcept
+        {
+            return cap;
+        }
+
+        template <typename T>
+        [[nodiscard]] T& get(size_t index) noexcept
+        {
+            return std::get<AlignedColumn<T, TAllocator>>(columns)[index];
+        }
+
+        template <typename T>
+        [[nodiscard]] const T& get(size_t index) const noexcept
+        {
+            return std::get<AlignedColumn<T, TAllocator>>(columns)[index];
+        }
+
+        template <typename T>
+        [[nodiscard]] T* data(size_t index) noexcept
+        {
+            return std::get<AlignedColumn<T, TAllocator>>(columns).data() + index;
+        }
+
+        template <typename T>
+        [[nodiscard]] const T* data(size_t index) const noexcept
+        {
+            return std::get<AlignedColumn<T, TAllocator>>(columns).data() + index;
+        }
+
+        void swap(size_t a, size_t b) noexcept
+        {
+            sxi::mpl::forTuple([a, b](auto& c){
+                std::swap(c[a], c[b]);
+            }, columns);
+        }
+
+        [[nodiscard]] size_t contiguousEnd(size_t, size_t end) const noexcept
+        {
+            return end;
+        }
+    };
+}
@@ -1,10 +1,36 @@
 #pragma once
 
+#include <stddef.h>
+#include <cstddef>
 #include <vector>
 #include <string>
 
 namespace sxi::file
 {
 	std::vector<char> readFileAsBytes(const std::string&);
-}
 
+	/**
+	 * @brief Read-only view of a whole file.
+	 *
+	 * The file is memory mapped where the platform supports it, so pages are
+	 * only read from disk when touched. Elsewhere it is read into memory.
+	 */
+	class MappedFile
+	{
+	public:
+		explicit MappedFile(const std::string&);
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		inline const std::byte* data() const noexcept { return bytes; }
+		inline size_t size() const noexcept { return length; }
+
+	private:
+		const std::byte* bytes = nullptr;
+		size_t length = 0;
+		bool mapped = false;
+		std::vector<char> buffer;
+	};
+}
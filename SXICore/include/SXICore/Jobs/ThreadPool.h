@@ -0,0 +1,147 @@
+#pragma once
+
+#include <stddef.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sxi::jobs
+{
+	using Job = std::function<void()>;
+
+	/**
+	 * @brief Counts jobs that are still in flight.
+	 *
+	 * Pass the same counter to every ThreadPool::submit of a batch and then
+	 * ThreadPool::wait on it. The first exception thrown by one of its jobs is
+	 * kept and rethrown by wait.
+	 */
+	class JobCounter
+	{
+	public:
+		inline bool done() const noexcept { return pending.load(std::memory_order_acquire) == 0; }
+
+	private:
+		std::atomic<size_t> pending{};
+
+		std::mutex exceptionMutex;
+		std::exception_ptr exception;
+
+		friend class ThreadPool;
+	};
+
+	/**
+	 * @brief Work-stealing thread pool.
+	 *
+	 * Every worker owns a deque: it pushes and pops its own jobs from the back
+	 * and steals from the front of the other deques when it runs dry. Jobs
+	 * submitted from outside the pool land in a shared queue every worker
+	 * steals from. Threads that wait on a JobCounter run jobs while waiting,
+	 * so jobs may submit and wait on other jobs without deadlocking.
+	 */
+	class ThreadPool
+	{
+	public:
+		/**
+		 * @brief Spawns the worker threads.
+		 *
+		 * @param size_t threadCount: Number of workers. The thread calling wait
+		 *                            also runs jobs, so the default leaves one
+		 *                            hardware thread for it.
+		 */
+		explicit ThreadPool(size_t=defaultThreadCount());
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		/**
+		 * @brief Queues a job. When called from a worker, the job goes to that
+		 * worker's own deque.
+		 *
+		 * @param Job job: Work to run. Jobs without a counter must not throw.
+		 * @param JobCounter* counter(=nullptr): Incremented now, decremented once
+		 *                                       the job has run.
+		 */
+		void submit(Job, JobCounter* =nullptr);
+
+		/**
+		 * @brief Blocks until the counter reaches zero, running queued jobs in
+		 * the meantime. Rethrows the first exception a job of the counter threw.
+		 */
+		void wait(JobCounter&);
+
+		/**
+		 * @brief Splits [begin, end) into chunks of at most grainSize and runs
+		 * func(chunkBegin, chunkEnd) on each of them across the pool. Returns
+		 * once every chunk has run.
+		 */
+		template <typename Func>
+		void parallelFor(size_t begin, size_t end, size_t grainSize, Func&& func)
+		{
+			if (grainSize == 0)
+				grainSize = 1;
+
+			JobCounter counter;
+			for (size_t chunkBegin = begin; chunkBegin < end; chunkBegin += grainSize)
+			{
+				size_t chunkEnd = end - chunkBegin > grainSize ? chunkBegin + grainSize : end;
+				submit([&func, chunkBegin, chunkEnd](){
+					func(chunkBegin, chunkEnd);
+				}, &counter);
+			}
+			wait(counter);
+		}
+
+		inline size_t workerCount() const noexcept { return threadCount; }
+
+		/**
+		 * @brief Index of the calling worker in [0, workerCount()), or
+		 * workerCount() when called from a thread that is not a worker.
+		 */
+		size_t currentWorkerIndex() const noexcept;
+
+		static size_t defaultThreadCount() noexcept;
+
+	private:
+		struct QueuedJob
+		{
+			Job job;
+			JobCounter* counter;
+		};
+
+		struct WorkQueue
+		{
+			std::mutex mutex;
+			std::deque<QueuedJob> jobs;
+		};
+
+		void workerLoop(size_t);
+		bool tryRunJob(size_t);
+		bool popOwn(size_t, QueuedJob&);
+		bool steal(size_t, QueuedJob&);
+
+		// set before any worker starts, unlike workers which is still filled while they run
+		const size_t threadCount;
+
+		// one deque per worker followed by the shared queue for external submissions
+		std::vector<std::unique_ptr<WorkQueue>> queues;
+		std::vector<std::thread> workers;
+
+		std::mutex sleepMutex;
+		std::condition_variable sleepCondition;
+		std::atomic<size_t> queuedJobs{};
+		bool stopping = false;
+	};
+
+	/**
+	 * @brief Engine-wide pool, created with the default thread count on first use.
+	 */
+	ThreadPool& threadPool();
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stddef.h>
+#include <utility>
+
+#include "TypeList.h"
+#include "Lookup.h"
+#include "Fold.h"
+
+namespace sxi::mpl
+{
+    namespace detail
+    {
+        // wraps a list so the fold below finds this operator and nothing else
+        template <typename List>
+        struct ConcatOperand
+        {
+            using type = List;
+        };
+
+        template <typename... Ts, typename... Us>
+        ConcatOperand<typelist<Ts..., Us...>> operator+(ConcatOperand<typelist<Ts...>>, ConcatOperand<typelist<Us...>>);
+
+        template <typename... Lists>
+        struct ConcatFold
+        {
+            using type = typename decltype((ConcatOperand<typelist<>>{} + ... + ConcatOperand<Lists>{}))::type;
+        };
+
+        template <bool Batched, typename... Lists>
+        struct Concat;
+
+        template <typename... Lists>
+        struct Concat<false, Lists...> : ConcatFold<Lists...> {};
+
+        // lists [Begin, Begin + sizeof...(Ks)) of All joined in a single fold
+        template <typename All, size_t Begin, typename Offsets>
+        struct ConcatRange;
+
+        template <typename All, size_t Begin, size_t... Ks>
+        struct ConcatRange<All, Begin, std::index_sequence<Ks...>> : ConcatFold<TypeAt<Begin + Ks, All>...> {};
+
+        template <typename All, size_t Count, typename Batches>
+        struct ConcatBatches;
+
+        constexpr size_t concatBatchSize(size_t count, size_t batch) noexcept
+        {
+            return count - batch * FOLD_BATCH < FOLD_BATCH ? count - batch * FOLD_BATCH : FOLD_BATCH;
+        }
+
+        template <typename All, size_t Count, size_t... Bs>
+        struct ConcatBatches<All, Count, std::index_sequence<Bs...>>
+        {
+            using type = typename Concat<(sizeof...(Bs) > FOLD_BATCH),
+                typename ConcatRange<All, Bs * FOLD_BATCH, std::make_index_sequence<concatBatchSize(Count, Bs)>>::type...>::type;
+        };
+
+        // more lists than one fold may take: join them in batches, then join the batches
+        template <typename... Lists>
+        struct Concat<true, Lists...>
+            : ConcatBatches<typelist<Lists...>, sizeof...(Lists),
+                            std::make_index_sequence<(sizeof...(Lists) + FOLD_BATCH - 1) / FOLD_BATCH>> {};
+    }
+
+    template <typename... Lists>
+    using Concat = typename detail::Concat<(sizeof...(Lists) > FOLD_BATCH), Lists...>::type;
+}
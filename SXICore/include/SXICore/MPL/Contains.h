@@ -1,27 +1,23 @@
 #pragma once
 
+#include <type_traits>
+
 #include "TypeList.h"
-#include "IsSame.h"
+#include "Lookup.h"
 
 namespace sxi::mpl
 {
-    template <typename T, class typelist> struct Contains;
-
-    template <typename T>
-    struct Contains<T, typelist<>>
-    {
-        static constexpr bool value = false;
-    };
-
-    template <typename T, typename... Tail>
-    struct Contains<T, typelist<T, Tail...>>
+    // the list is passed through whole, so queries never re-expand its elements
+    template <typename T, class List>
+    struct Contains
     {
-        static constexpr bool value = true;
+        static constexpr bool value = std::is_base_of_v<Type<T>, detail::IndexedTypes<List>>;
     };
 
-    template <typename T, typename Head, typename... Tail>
-    struct Contains<T, typelist<Head, Tail...>>
+    template <typename List>
+    struct ContainedIn
     {
-        static constexpr bool value = IsSame<T, Head>::value || Contains<T, typelist<Tail...>>::value;
+        template <typename T>
+        using Filter = std::bool_constant<Contains<T, List>::value>;
     };
-}
\ No newline at end of file
+}
@@ -8,15 +8,9 @@ namespace sxi::mpl
 {
     template <class typelist> struct Count;
 
-    template <>
-    struct Count<typelist<>>
+    template <typename... Ts>
+    struct Count<typelist<Ts...>>
     {
-        static constexpr size_t value = 0;
+        static constexpr size_t value = sizeof...(Ts);
     };
-
-    template <typename Head, typename... Tail>
-    struct Count<typelist<Head, Tail...>>
-    {
-        static constexpr size_t value = 1 + Count<typelist<Tail...>>::value;
-    };
-}
\ No newline at end of file
+}
@@ -1,36 +1,23 @@
 #pragma once
 
-#include "PushFront.h"
+#include <type_traits>
+
+#include "Concat.h"
 
 namespace sxi::mpl
 {
     namespace detail 
     {
-        template <template <typename> class Pred, typename... List> struct Filter;
-        
-        template <template <typename> class Pred, typename Head, typename... Tail>
-        struct Filter<Pred, typelist<Head, Tail...>>
-        {
-            using type = std::conditional_t<Pred<Head>::value,
-                                            typename PushFront<Head, typename Filter<Pred, typelist<Tail...>>::type>::type,
-                                            typename Filter<Pred, typelist<Tail...>>::type>;
-        };
-        
-        template <template <typename> class Pred, typename Head>
-        struct Filter<Pred, typelist<Head>>
-        {
-            using type = std::conditional_t<Pred<Head>::value,
-                                            typelist<Head>,
-                                            typelist<>>;
-        };
-        
-        template <template <typename> class Pred>
-        struct Filter<Pred, typelist<>>
+        template <template <typename> class Pred, typename List> struct Filter;
+
+        // every element becomes a list of zero or one types, joined in a single fold
+        template <template <typename> class Pred, typename... Ts>
+        struct Filter<Pred, typelist<Ts...>>
         {
-            using type = typelist<>;
+            using type = mpl::Concat<std::conditional_t<Pred<Ts>::value, typelist<Ts>, typelist<>>...>;
         };
     }
 
     template <template <typename> class Pred, typename TypeList>
     using Filter = typename detail::Filter<Pred, TypeList>::type;
-}
\ No newline at end of file
+}
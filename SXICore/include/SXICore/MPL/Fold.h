@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stddef.h>
+
+namespace sxi::mpl
+{
+    // most operands a fold expression may take. Clang nests a fold's operands
+    // and rejects any deeper than -fbracket-depth, 256 by default, so folds over
+    // whole lists run in batches of this size
+    inline constexpr size_t FOLD_BATCH = 64;
+
+    // a pack expanded into an array has no nesting at all, unlike a || fold
+    template <bool... Bs>
+    constexpr bool any() noexcept
+    {
+        constexpr bool values[] = { false, Bs... };
+        for (bool value : values)
+            if (value)
+                return true;
+        return false;
+    }
+
+    template <bool... Bs>
+    constexpr bool all() noexcept
+    {
+        constexpr bool values[] = { true, Bs... };
+        for (bool value : values)
+            if (!value)
+                return false;
+        return true;
+    }
+}
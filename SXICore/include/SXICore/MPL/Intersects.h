@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Contains.h"
+#include "Fold.h"
+
+namespace sxi::mpl
+{
+    template <typename List, typename Other>
+    struct Intersects;
+
+    template <typename... Ts, typename Other>
+    struct Intersects<typelist<Ts...>, Other>
+    {
+        static constexpr bool value = any<Contains<Ts, Other>::value...>();
+    };
+}
@@ -1,28 +1,17 @@
 #pragma once
 
 #include "Contains.h"
+#include "Fold.h"
 
 namespace sxi::mpl
 {
-    template <typename List, typename Head, typename... Tail>
+    template <typename List, typename Subset>
     struct IsSubset;
-    
-    template <typename List, typename Head, typename... Tail>
-    struct IsSubset<List, typelist<Head, Tail...>>
-    {
-        static constexpr bool value = Contains<Head, List>::value && IsSubset<List, typelist<Tail...>>::value;
-    };
-    
-    template <typename List, typename Head>
-    struct IsSubset<List, typelist<Head>>
-    {
-        static constexpr bool value = Contains<Head, List>::value;
-    };
-    
-    template <typename List>
-    struct IsSubset<List, typelist<>>
+
+    template <typename List, typename... Ts>
+    struct IsSubset<List, typelist<Ts...>>
     {
-        static constexpr bool value = true;
+        static constexpr bool value = all<Contains<Ts, List>::value...>();
     };
 
     using Set = typelist<int, short, char, long>;
@@ -32,4 +21,4 @@ namespace sxi::mpl
 
     static_assert(IsSubset<Set, WillPass>::value);
     static_assert(!IsSubset<Set, WillFail>::value);
-}
\ No newline at end of file
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stddef.h>
+#include <type_traits>
+#include <utility>
+
+#include "Type.h"
+#include "TypeList.h"
+
+namespace sxi::mpl::detail
+{
+    // element I of a list, also a Type<T> so membership is a single base class lookup
+    template <size_t I, typename T>
+    struct IndexedType : Type<T> {};
+
+    template <typename Indices, typename... Ts>
+    struct IndexedTypesImpl;
+
+    template <size_t... Is, typename... Ts>
+    struct IndexedTypesImpl<std::index_sequence<Is...>, Ts...> : IndexedType<Is, Ts>... {};
+
+    /**
+     * @brief Derives from every element of a list at once. Instantiated once per
+     * list, after which membership and index queries are resolved by the compiler's
+     * base class lookup instead of one template instantiation per element.
+     */
+    template <typename List>
+    struct IndexedTypes;
+
+    template <typename... Ts>
+    struct IndexedTypes<typelist<Ts...>> : IndexedTypesImpl<std::index_sequence_for<Ts...>, Ts...> {};
+
+    // only named in decltype, I selects the single base T is deduced from
+    template <size_t I, typename T>
+    Type<T> typeAtBase(const IndexedType<I, T>*) noexcept;
+
+    template <size_t I, typename List>
+    using TypeAt = typename decltype(typeAtBase<I>(static_cast<const IndexedTypes<List>*>(nullptr)))::type;
+
+    template <typename T, size_t I>
+    constexpr size_t indexOfBase(const IndexedType<I, T>*) noexcept
+    {
+        return I;
+    }
+
+    // chosen when T is missing, or listed more than once and the base is ambiguous
+    template <typename T>
+    constexpr size_t indexOfBase(const void*) noexcept
+    {
+        return static_cast<size_t>(-1);
+    }
+
+    // linear fallback, only reached for lists holding T more than once. An array
+    // rather than a fold, which clang limits to -fbracket-depth operands
+    template <typename T, typename... Ts>
+    constexpr size_t firstIndexOf(typelist<Ts...>) noexcept
+    {
+        constexpr bool same[] = { std::is_same_v<T, Ts>..., true };
+        size_t index = 0;
+        while (!same[index])
+            ++index;
+        return index;
+    }
+
+    template <typename T, typename List>
+    constexpr size_t indexOf() noexcept
+    {
+        constexpr size_t unique = indexOfBase<T>(static_cast<const IndexedTypes<List>*>(nullptr));
+        if constexpr (unique != static_cast<size_t>(-1) || !std::is_base_of_v<Type<T>, IndexedTypes<List>>)
+            return unique;
+        else
+            return firstIndexOf<T>(List{});
+    }
+}
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "PushFront.h"
+#include "TypeList.h"
 
 namespace sxi::mpl
 {
@@ -8,25 +8,13 @@ namespace sxi::mpl
     {
         template <template <typename> typename Func, typename List> struct Map;
 
-        template <template <typename> typename Func, typename Head, typename... Tail>
-        struct Map<Func, typelist<Head, Tail...>>
+        template <template <typename> typename Func, typename... Ts>
+        struct Map<Func, typelist<Ts...>>
         {
-            using type = PushFront<Func<Head>, typename Map<Func, typelist<Tail...>>::type>::type;
-        };
-
-        template <template <typename> typename Func, typename Head>
-        struct Map<Func, typelist<Head>>
-        {
-            using type = typelist<Func<Head>>;
-        };
-
-        template <template <typename> typename Func>
-        struct Map<Func, typelist<>>
-        {
-            using type = typelist<>;
+            using type = typelist<Func<Ts>...>;
         };
     }
 
     template <template <typename> class Func, typename TypeList>
     using Map = typename detail::Map<Func, TypeList>::type;
-}
\ No newline at end of file
+}
@@ -1,35 +1,28 @@
 #pragma once
 
 #include <stddef.h>
+#include <utility>
 
-#include "PushFront.h"
+#include "TypeList.h"
 
 namespace sxi::mpl
 {
     namespace detail
     {
+        template <size_t, typename T>
+        using RepeatElement = T;
 
-        template <size_t times, typename T> struct Repeat;
-        
-        template <size_t times, typename T>
-        struct Repeat
-        {
-            using type = PushFront<T, typename Repeat<times - 1, T>::type>::type;
-        };
-        
-        template <typename T>
-        struct Repeat<1, T>
-        {
-            using type = typelist<T>;
-        };
-        
-        template <typename T>
-        struct Repeat<0, T>
+        template <typename T, typename Indices> struct Repeat;
+
+        template <typename T, size_t... Is>
+        struct Repeat<T, std::index_sequence<Is...>>
         {
-            static_assert(false, "Cannot repeat type 0 times");
+            static_assert(sizeof...(Is) > 0, "Cannot repeat type 0 times");
+
+            using type = typelist<RepeatElement<Is, T>...>;
         };
     }
 
     template <size_t times, typename T>
-    using Repeat = typename detail::Repeat<times, T>::type;
-}
\ No newline at end of file
+    using Repeat = typename detail::Repeat<T, std::make_index_sequence<times>>::type;
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <stddef.h>
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "Types.h"
+
+namespace sxi::profiler
+{
+	/**
+	 * @brief Turns recording on or off. Off by default, disabled scopes only cost
+	 * a relaxed atomic load.
+	 */
+	void setEnabled(bool) noexcept;
+
+	inline std::atomic<bool> enabledFlag{ false };
+
+	inline bool enabled() noexcept { return enabledFlag.load(std::memory_order_relaxed); }
+
+	/**
+	 * @brief Names the calling thread in exported traces.
+	 */
+	void setThreadName(const std::string&);
+
+	/**
+	 * @brief Drops everything recorded so far.
+	 */
+	void clear() noexcept;
+
+	/**
+	 * @brief Writes every recorded scope in the Chrome trace event format, which
+	 * about:tracing, Perfetto and Speedscope open.
+	 *
+	 * Safe to call while other threads keep recording. Every thread keeps only
+	 * its most recent eventsPerThread scopes.
+	 */
+	void writeChromeTrace(std::ostream&);
+	void writeChromeTrace(const std::string&);
+
+	inline constexpr size_t eventsPerThread = 1 << 15;
+
+	namespace detail
+	{
+		u64 now() noexcept;
+		void record(const char*, const char*, u64, u64) noexcept;
+
+		template <typename T>
+		constexpr std::string_view signature() noexcept
+		{
+#if defined(_MSC_VER) && !defined(__clang__)
+			return __FUNCSIG__;
+#else
+			return __PRETTY_FUNCTION__;
+#endif
+		}
+
+		std::string parseTypeName(std::string_view);
+	}
+
+	/**
+	 * @brief Readable name of T with static storage duration, meant as a scope
+	 * name or detail.
+	 */
+	template <typename T>
+	const char* typeName()
+	{
+		static const std::string name = detail::parseTypeName(detail::signature<T>());
+		return name.c_str();
+	}
+
+	/**
+	 * @brief Records the time between its construction and destruction on the
+	 * calling thread.
+	 *
+	 * Name and detail are not copied, they must outlive the profiler: string
+	 * literals or typeName<T>().
+	 */
+	class Scope
+	{
+	public:
+		explicit Scope(const char* name, const char* detail=nullptr) noexcept
+			: name(name), info(detail), begin(enabled() ? profiler::detail::now() : 0)
+		{
+		}
+
+		~Scope()
+		{
+			if (begin != 0)
+				profiler::detail::record(name, info, begin, profiler::detail::now());
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+		const char* name;
+		const char* info;
+		u64 begin;
+	};
+}
+
+#define SXI_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SXI_PROFILE_CONCAT(a, b) SXI_PROFILE_CONCAT_IMPL(a, b)
+
+// define SXI_DISABLE_PROFILER to compile every scope out
+#ifdef SXI_DISABLE_PROFILER
+#define SXI_PROFILE_SCOPE(...) ((void)0)
+#else
+#define SXI_PROFILE_SCOPE(...) ::sxi::profiler::Scope SXI_PROFILE_CONCAT(sxiProfileScope, __COUNTER__)(__VA_ARGS__)
+#endif
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/vec3.hpp>
+#include <glm/geometric.hpp>
+
+namespace sxi
+{
+	/**
+	 * @brief Uniform grid of 3D points, hashed by cell, for neighbour queries whose
+	 * cost depends on the points near the query rather than on all points.
+	 *
+	 * Points are identified by small dense ids such as entity indices. Moving a
+	 * point only touches its old and new cell.
+	 */
+	class SpatialHash
+	{
+	public:
+		explicit SpatialHash(float cellSize = 16.f);
+
+		/**
+		 * @brief Inserts the point or moves it if id is already present.
+		 */
+		void update(size_t id, const glm::vec3& point);
+		void remove(size_t id);
+		// removes every id >= count, e.g. after entities at the back were destroyed
+		void truncate(size_t count);
+		void clear();
+
+		inline bool contains(size_t id) const { return id < keys.size() && keys[id] != NO_KEY; }
+		inline const glm::vec3& point(size_t id) const { return points[id]; }
+		inline float cellSize() const { return size; }
+
+		/**
+		 * @brief Calls func(id) for every point within radius of center.
+		 */
+		template <typename Func>
+		void forEachInRadius(const glm::vec3& center, float radius, Func&& func) const
+		{
+			const float sqrRadius = radius * radius;
+			forEachInCells(center - glm::vec3(radius), center + glm::vec3(radius), [this, &center, sqrRadius, &func](size_t id){
+				if (glm::dot(points[id] - center, points[id] - center) <= sqrRadius)
+					func(id);
+			});
+		}
+
+		/**
+		 * @brief Calls func(id) for every point inside the box spanned by min and max.
+		 */
+		template <typename Func>
+		void forEachInBox(const glm::vec3& min, const glm::vec3& max, Func&& func) const
+		{
+			forEachInCells(min, max, [this, &min, &max, &func](size_t id){
+				const glm::vec3& p = points[id];
+				if (min.x <= p.x && p.x <= max.x && min.y <= p.y && p.y <= max.y && min.z <= p.z && p.z <= max.z)
+					func(id);
+			});
+		}
+
+	private:
+		static constexpr uint64_t NO_KEY = UINT64_MAX;
+
+		// 21 bits per axis, cells outside that range share the border cells
+		static constexpr int32_t CELL_LIMIT = (1 << 20) - 1;
+
+		inline int32_t cellCoord(float x) const
+		{
+			float cell = std::floor(x / size);
+			return cell < -CELL_LIMIT ? -CELL_LIMIT : cell > CELL_LIMIT ? CELL_LIMIT : (int32_t) cell;
+		}
+
+		static inline uint64_t key(int32_t x, int32_t y, int32_t z)
+		{
+			constexpr uint64_t mask = (1 << 21) - 1;
+			return (uint64_t(x + CELL_LIMIT) & mask) | ((uint64_t(y + CELL_LIMIT) & mask) << 21) | ((uint64_t(z + CELL_LIMIT) & mask) << 42);
+		}
+
+		void removeFromCell(uint64_t cellKey, size_t id);
+
+		template <typename Func>
+		void forEachInCells(const glm::vec3& min, const glm::vec3& max, Func&& func) const
+		{
+			const int32_t x0 = cellCoord(min.x), y0 = cellCoord(min.y), z0 = cellCoord(min.z);
+			const int32_t x1 = cellCoord(max.x), y1 = cellCoord(max.y), z1 = cellCoord(max.z);
+			const uint64_t cellCount = uint64_t(x1 - x0 + 1) * uint64_t(y1 - y0 + 1) * uint64_t(z1 - z0 + 1);
+
+			// huge queries walk the occupied cells instead of the empty ones
+			if (cellCount > cells.size())
+			{
+				for (const auto& [cellKey, ids] : cells)
+					for (size_t id : ids)
+						func(id);
+				return;
+			}
+
+			for (int32_t z = z0; z <= z1; ++z)
+				for (int32_t y = y0; y <= y1; ++y)
+					for (int32_t x = x0; x <= x1; ++x)
+					{
+						auto it = cells.find(key(x, y, z));
+						if (it == cells.end())
+							continue;
+						for (size_t id : it->second)
+							func(id);
+					}
+		}
+
+		float size;
+		std::unordered_map<uint64_t, std::vector<size_t>> cells;
+		// indexed by id
+		std::vector<glm::vec3> points;
+		std::vector<uint64_t> keys;
+	};
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "../ECS/Entity.h"
+
+namespace sxi::ecs
+{
+    /**
+     * @brief Attaches an entity to a parent of the same archetype, e.g. a chair
+     * on a cart. Entities without a parent, or whose parent died, are roots.
+     *
+     * Snapshots save parent as is, without remapping it to the loaded entities.
+     * After loading one a parent reports dead or refers to an unrelated entity,
+     * so parents have to be set again.
+     */
+    struct HierarchyComponent final
+    {
+        AnyEntityHandle parent{};
+
+        // maintained by TransformPropagation: the parent the world transform was
+        // last computed against, to notice reparenting
+        AnyEntityHandle propagatedParent{};
+        bool propagated = false;
+    };
+}
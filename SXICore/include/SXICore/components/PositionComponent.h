@@ -1,6 +1,7 @@
 #pragma once
 
 #include "SXIMath/Vec.h"
+#include "../ECS/SplitComponent.h"
 
 namespace sxi::ecs
 {
@@ -8,4 +9,13 @@ namespace sxi::ecs
     {
         glm::vec3 pos;
     };
-}
\ No newline at end of file
+
+    // stored as separate x, y and z columns. Declared with the component so every
+    // translation unit using it sees the same layout
+    template <>
+    struct SplitComponent<PositionComponent>
+    {
+        using Field = float;
+        static constexpr size_t fieldCount = 3;
+    };
+}
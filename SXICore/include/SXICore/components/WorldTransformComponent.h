@@ -0,0 +1,14 @@
+#pragma once
+
+#include "SXIMath/Mat.h"
+
+namespace sxi::ecs
+{
+    /**
+     * @brief Model matrix of an entity, written by TransformPropagation.
+     */
+    struct WorldTransformComponent final
+    {
+        glm::mat4 world{ 1.f };
+    };
+}
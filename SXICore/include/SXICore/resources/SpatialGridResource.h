@@ -0,0 +1,118 @@
+#pragma once
+
+#include <stddef.h>
+#include <tuple>
+#include <vector>
+
+#include "../ECS/Entity.h"
+#include "../ECS/Manager.h"
+#include "../MPL/Contains.h"
+#include "../MPL/Map.h"
+#include "../MPL/Tuple.h"
+#include "../MPL/TypeListOperations.h"
+#include "../SpatialHash.h"
+#include "../Types.h"
+#include "../components/PositionComponent.h"
+
+namespace sxi::ecs
+{
+    /**
+     * @brief Uniform grid over the PositionComponent of every TArchetypeList entity,
+     * answering radius and box queries in time proportional to the entities near
+     * the query instead of a scan over all of them.
+     *
+     * List it in the settings' ResourceList and run SpatialGridUpdate to keep it
+     * current. Positions must be tracked: each update only revisits the version
+     * blocks whose positions changed. Disabled entities are indexed as well.
+     */
+    template <typename TArchetypeList>
+    class SpatialGridResource final
+    {
+        template <typename TArchetype>
+        struct Cells
+        {
+            SpatialHash hash;
+        };
+
+        mpl::Tuple<mpl::Map<Cells, TArchetypeList>> archetypes;
+        float size;
+        // world version the grid was last brought up to date with
+        u64 syncedVersion = 0;
+
+        template <typename TArchetype>
+        const SpatialHash& cells() const noexcept
+        {
+            static_assert(mpl::Contains<TArchetype, TArchetypeList>::value, "TArchetype is not indexed by this grid");
+
+            return std::get<Cells<TArchetype>>(archetypes).hash;
+        }
+
+    public:
+        explicit SpatialGridResource(float cellSize = 16.f) : size(cellSize)
+        {
+            setCellSize(cellSize);
+        }
+
+        /**
+         * @brief Queries work best with cells about as large as the usual query
+         * radius. Changing it rebuilds the grid on the next update.
+         */
+        void setCellSize(float cellSize)
+        {
+            size = cellSize;
+            syncedVersion = 0;
+            mpl::forTuple([cellSize](auto& archetype){
+                archetype.hash = SpatialHash(cellSize);
+            }, archetypes);
+        }
+
+        [[nodiscard]] float cellSize() const noexcept
+        {
+            return size;
+        }
+
+        template <typename TSettings>
+        void update(const Manager<TSettings>& mgr)
+        {
+            const u64 version = mgr.version();
+            mpl::forTypes<TArchetypeList>([this, &mgr](auto t){
+                using TArchetype = SXI_MPL_TYPE(t);
+                static_assert(mpl::Contains<PositionComponent, TArchetype>::value, "Indexed archetypes need a PositionComponent");
+                static_assert(TSettings::template isTracked<PositionComponent>(), "PositionComponent must be tracked");
+
+                SpatialHash& hash = std::get<Cells<TArchetype>>(archetypes).hash;
+                // entities destroyed at the back, the ones swapped into their slots were stamped
+                hash.truncate(mgr.template entityCount<TArchetype>());
+                mgr.template forIndicesChanged<TArchetype, PositionComponent>(syncedVersion, [&hash, &mgr](EntityIndex<TArchetype> i){
+                    const PositionComponent position = mgr.template component<PositionComponent>(i);
+                    hash.update(i, position.pos);
+                });
+            });
+            syncedVersion = version;
+        }
+
+        /**
+         * @brief Replaces out with the TArchetype entities within radius of center.
+         */
+        template <typename TArchetype>
+        void queryRadius(const glm::vec3& center, float radius, std::vector<EntityIndex<TArchetype>>& out) const
+        {
+            out.clear();
+            cells<TArchetype>().forEachInRadius(center, radius, [&out](size_t i){
+                out.push_back(EntityIndex<TArchetype>{i});
+            });
+        }
+
+        /**
+         * @brief Replaces out with the TArchetype entities inside the box spanned by min and max.
+         */
+        template <typename TArchetype>
+        void queryAABB(const glm::vec3& min, const glm::vec3& max, std::vector<EntityIndex<TArchetype>>& out) const
+        {
+            out.clear();
+            cells<TArchetype>().forEachInBox(min, max, [&out](size_t i){
+                out.push_back(EntityIndex<TArchetype>{i});
+            });
+        }
+    };
+}
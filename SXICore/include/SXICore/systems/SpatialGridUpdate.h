@@ -0,0 +1,28 @@
+#pragma once
+
+#include <utility>
+
+#include "../ECS/Manager.h"
+#include "../ECS/Scheduler.h"
+#include "../components/PositionComponent.h"
+#include "../resources/SpatialGridResource.h"
+
+namespace sxi::ecs
+{
+    /**
+     * @brief Scheduler system bringing SpatialGridResource<TArchetypeList> up to
+     * date with the positions written earlier in the frame. Systems querying the
+     * grid list it in their ReadList.
+     */
+    template <typename TSettings, typename TArchetypeList>
+    struct SpatialGridUpdate final : System<
+        Signature<PositionComponent>,
+        ReadList<PositionComponent>,
+        WriteList<SpatialGridResource<TArchetypeList>>>
+    {
+        void run(Manager<TSettings>& mgr)
+        {
+            mgr.template resource<SpatialGridResource<TArchetypeList>>().update(std::as_const(mgr));
+        }
+    };
+}
@@ -0,0 +1,208 @@
+#pragma once
+
+#include <stddef.h>
+#include <assert.h>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "../ECS/Manager.h"
+#include "../ECS/Scheduler.h"
+#include "../ECS/SplitComponent.h"
+#include "../Jobs/ThreadPool.h"
+#include "../Types.h"
+#include "../components/PositionComponent.h"
+#include "../components/YRotationComponent.h"
+#include "../components/HierarchyComponent.h"
+#include "../components/WorldTransformComponent.h"
+
+namespace sxi::ecs
+{
+    /**
+     * @brief Scheduler system writing every TArchetype entity's
+     * WorldTransformComponent from its PositionComponent and YRotationComponent,
+     * relative to the world transform of its HierarchyComponent parent.
+     *
+     * Each run resolves parents and sorts entities by depth, then computes one
+     * depth level at a time. Entities of a level only read the level above, so
+     * each level is spread across the job system. When both local components are
+     * tracked, entities whose local transform, parent and ancestors are unchanged
+     * (at the block granularity of Manager::changedSince) are skipped along with
+     * their whole subtree, and only the world transforms written are marked as
+     * changed.
+     *
+     * Parents must belong to TArchetype as well.
+     */
+    template <typename TSettings, typename TArchetype>
+    class TransformPropagation final : public System<
+        Signature<PositionComponent, YRotationComponent, HierarchyComponent, WorldTransformComponent>,
+        ReadList<PositionComponent, YRotationComponent>>
+    {
+        static_assert(!isSplitComponent<WorldTransformComponent>(), "WorldTransformComponent cannot be split");
+
+        static constexpr size_t NO_PARENT = std::numeric_limits<size_t>::max();
+        static constexpr u32 UNVISITED = std::numeric_limits<u32>::max();
+        static constexpr u32 VISITING = UNVISITED - 1;
+        static constexpr bool tracksLocal = TSettings::template isTracked<PositionComponent>() &&
+                                            TSettings::template isTracked<YRotationComponent>();
+
+        // indexed by entity index, rebuilt every run
+        std::vector<size_t> parents;
+        std::vector<u32> depths;
+        std::vector<u8> dirty;
+        std::vector<size_t> path;
+
+        // entity indices sorted by depth, levelStarts[d] is where depth d begins
+        std::vector<size_t> order;
+        std::vector<size_t> levelStarts;
+        // world transforms to write, parallel to order once clean entities are dropped
+        std::vector<WorldTransformComponent*> targets;
+
+        u64 sinceVersion = 0;
+
+        void resolveParents(Manager<TSettings>& mgr)
+        {
+            parents.clear();
+            mgr.template forEntities<TArchetype>([this, &mgr](EntityIndex<TArchetype> i){
+                const AnyEntityHandle& parent = std::as_const(mgr).template component<HierarchyComponent>(i).parent;
+                EntityHandle<TArchetype> handle(parent);
+                parents.push_back(!parent.empty() && mgr.isAlive(handle) ? size_t(mgr.entityIndex(handle)) : NO_PARENT);
+            });
+        }
+
+        void computeDepths()
+        {
+            depths.assign(parents.size(), UNVISITED);
+            for (size_t i = 0; i < parents.size(); ++i)
+            {
+                path.clear();
+                size_t j = i;
+                for (; j != NO_PARENT && depths[j] == UNVISITED; j = parents[j])
+                {
+                    depths[j] = VISITING;
+                    path.push_back(j);
+                }
+
+                u32 depth = 0;
+                if (j != NO_PARENT && depths[j] == VISITING)
+                {
+                    assert(false && "Entity hierarchies cannot contain cycles");
+                    // the topmost entity of the cycle becomes a root
+                    parents[path.back()] = NO_PARENT;
+                }
+                else if (j != NO_PARENT)
+                {
+                    depth = depths[j] + 1;
+                }
+
+                for (auto it = path.rbegin(); it != path.rend(); ++it, ++depth)
+                    depths[*it] = depth;
+            }
+        }
+
+        void sortByDepth()
+        {
+            levelStarts.clear();
+            for (u32 depth : depths)
+            {
+                if (depth + 2 > levelStarts.size())
+                    levelStarts.resize(depth + 2, 0);
+                ++levelStarts[depth + 1];
+            }
+            for (size_t d = 1; d < levelStarts.size(); ++d)
+                levelStarts[d] += levelStarts[d - 1];
+
+            order.resize(depths.size());
+            std::vector<size_t> next(levelStarts.begin(), levelStarts.end());
+            for (size_t i = 0; i < depths.size(); ++i)
+                order[next[depths[i]]++] = i;
+        }
+
+        // drops clean entities from order, parents come first so dirtiness flows down
+        void collectDirty(Manager<TSettings>& mgr)
+        {
+            dirty.assign(order.size(), 0);
+            targets.clear();
+            size_t kept = 0;
+            for (size_t d = 0; d + 1 < levelStarts.size(); ++d)
+            {
+                size_t begin = levelStarts[d], end = levelStarts[d + 1];
+                levelStarts[d] = kept;
+                for (size_t k = begin; k < end; ++k)
+                {
+                    EntityIndex<TArchetype> i{order[k]};
+                    size_t parent = parents[i];
+                    const HierarchyComponent& hierarchy = std::as_const(mgr).template component<HierarchyComponent>(i);
+                    AnyEntityHandle parentHandle = parent == NO_PARENT ? AnyEntityHandle{} : hierarchy.parent;
+
+                    bool reparented = !hierarchy.propagated || hierarchy.propagatedParent != parentHandle;
+                    bool changed = reparented || (parent != NO_PARENT && dirty[parent]);
+                    if constexpr (tracksLocal)
+                        changed = changed || mgr.template changedSince<PositionComponent, YRotationComponent>(i, sinceVersion);
+                    else
+                        changed = true;
+
+                    if (!changed)
+                        continue;
+
+                    dirty[i] = 1;
+                    if (reparented)
+                    {
+                        HierarchyComponent& written = mgr.template component<HierarchyComponent>(i);
+                        written.propagatedParent = parentHandle;
+                        written.propagated = true;
+                    }
+                    order[kept++] = i;
+                    targets.push_back(&mgr.template component<WorldTransformComponent>(i));
+                }
+            }
+            if (!levelStarts.empty())
+                levelStarts.back() = kept;
+        }
+
+        void propagate(const Manager<TSettings>& mgr, size_t begin, size_t end) const
+        {
+            for (size_t k = begin; k < end; ++k)
+            {
+                EntityIndex<TArchetype> i{order[k]};
+                const PositionComponent position = mgr.template component<PositionComponent>(i);
+                const YRotationComponent rotation = mgr.template component<YRotationComponent>(i);
+                glm::mat4 local = glm::rotate(glm::translate(glm::mat4(1.f), position.pos), rotation.rot, SXI_VEC3_UP);
+
+                size_t parent = parents[i];
+                targets[k]->world = parent == NO_PARENT
+                    ? local
+                    : mgr.template component<WorldTransformComponent>(EntityIndex<TArchetype>{parent}).world * local;
+            }
+        }
+
+    public:
+        // entities per job within one depth level
+        size_t grainSize = 256;
+
+        void run(Manager<TSettings>& mgr)
+        {
+            static_assert(TSettings::template isArchetype<TArchetype>(), "TArchetype must be an archetype");
+
+            const u64 version = mgr.version();
+            resolveParents(mgr);
+            computeDepths();
+            sortByDepth();
+            collectDirty(mgr);
+
+            jobs::ThreadPool& pool = jobs::threadPool();
+            const Manager<TSettings>& readOnly = mgr;
+            for (size_t d = 0; d + 1 < levelStarts.size(); ++d)
+            {
+                size_t begin = levelStarts[d], end = levelStarts[d + 1];
+                if (end - begin <= grainSize)
+                    propagate(readOnly, begin, end);
+                else
+                    pool.parallelFor(begin, end, grainSize, [this, &readOnly](size_t chunkBegin, size_t chunkEnd){
+                        propagate(readOnly, chunkBegin, chunkEnd);
+                    });
+            }
+            sinceVersion = version;
+        }
+    };
+}
@@ -2,6 +2,13 @@
 
 #include <fstream>
 
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "Exception.h"
 
 namespace sxi::file
@@ -20,4 +27,46 @@ namespace sxi::file
 
 		return buffer;
 	}
+
+	MappedFile::MappedFile(const std::string& filename)
+	{
+#if defined(__unix__) || defined(__APPLE__)
+		int fd = open(filename.c_str(), O_RDONLY);
+		if (fd < 0)
+			throw InvalidArgumentException("Failed to open file");
+
+		struct stat info;
+		if (fstat(fd, &info) != 0)
+		{
+			close(fd);
+			throw InvalidArgumentException("Failed to read file size");
+		}
+
+		length = static_cast<size_t>(info.st_size);
+		if (length > 0)
+		{
+			void* memory = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (memory != MAP_FAILED)
+			{
+				madvise(memory, length, MADV_SEQUENTIAL);
+				bytes = static_cast<const std::byte*>(memory);
+				mapped = true;
+			}
+		}
+		close(fd);
+		if (mapped || length == 0)
+			return;
+#endif
+		buffer = readFileAsBytes(filename);
+		bytes = reinterpret_cast<const std::byte*>(buffer.data());
+		length = buffer.size();
+	}
+
+	MappedFile::~MappedFile()
+	{
+#if defined(__unix__) || defined(__APPLE__)
+		if (mapped)
+			munmap(const_cast<std::byte*>(bytes), length);
+#endif
+	}
 }
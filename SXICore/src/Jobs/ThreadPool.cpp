@@ -0,0 +1,165 @@
+#include "Jobs/ThreadPool.h"
+#include "Profiler.h"
+
+#include <string>
+
+namespace sxi::jobs
+{
+	static thread_local const ThreadPool* currentPool = nullptr;
+	static thread_local size_t currentIndex = 0;
+
+	ThreadPool::ThreadPool(size_t threadCount) : threadCount(threadCount)
+	{
+		queues.reserve(threadCount + 1);
+		for (size_t i = 0; i <= threadCount; ++i)
+			queues.push_back(std::make_unique<WorkQueue>());
+
+		workers.reserve(threadCount);
+		for (size_t i = 0; i < threadCount; ++i)
+			workers.emplace_back(&ThreadPool::workerLoop, this, i);
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			stopping = true;
+		}
+		sleepCondition.notify_all();
+
+		for (std::thread& worker : workers)
+			worker.join();
+	}
+
+	void ThreadPool::submit(Job job, JobCounter* counter)
+	{
+		if (counter)
+			counter->pending.fetch_add(1, std::memory_order_relaxed);
+
+		WorkQueue& queue = *queues[currentWorkerIndex()];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.jobs.push_back(QueuedJob{ std::move(job), counter });
+		}
+		queuedJobs.fetch_add(1, std::memory_order_release);
+
+		// taking the lock orders this notify after any worker that just saw an empty pool went to sleep
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+		}
+		sleepCondition.notify_one();
+	}
+
+	void ThreadPool::wait(JobCounter& counter)
+	{
+		size_t index = currentWorkerIndex();
+		while (!counter.done())
+		{
+			if (!tryRunJob(index))
+				std::this_thread::yield();
+		}
+
+		std::exception_ptr exception;
+		{
+			std::lock_guard<std::mutex> lock(counter.exceptionMutex);
+			std::swap(exception, counter.exception);
+		}
+		if (exception)
+			std::rethrow_exception(exception);
+	}
+
+	size_t ThreadPool::currentWorkerIndex() const noexcept
+	{
+		return currentPool == this ? currentIndex : threadCount;
+	}
+
+	size_t ThreadPool::defaultThreadCount() noexcept
+	{
+		size_t hardwareThreads = std::thread::hardware_concurrency();
+		return hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	void ThreadPool::workerLoop(size_t index)
+	{
+		currentPool = this;
+		currentIndex = index;
+		profiler::setThreadName("Worker " + std::to_string(index));
+
+		while (true)
+		{
+			if (tryRunJob(index))
+				continue;
+
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			sleepCondition.wait(lock, [this](){
+				return stopping || queuedJobs.load(std::memory_order_acquire) > 0;
+			});
+			if (stopping)
+				return;
+		}
+	}
+
+	bool ThreadPool::tryRunJob(size_t index)
+	{
+		QueuedJob queued;
+		if (!popOwn(index, queued) && !steal(index, queued))
+			return false;
+
+		queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+		try
+		{
+			queued.job();
+		}
+		catch (...)
+		{
+			// nobody waits on a job without a counter, so there is nowhere to report to
+			if (!queued.counter)
+				std::terminate();
+
+			std::lock_guard<std::mutex> lock(queued.counter->exceptionMutex);
+			if (!queued.counter->exception)
+				queued.counter->exception = std::current_exception();
+		}
+		if (queued.counter)
+			queued.counter->pending.fetch_sub(1, std::memory_order_release);
+
+		return true;
+	}
+
+	bool ThreadPool::popOwn(size_t index, QueuedJob& out)
+	{
+		if (index >= threadCount)
+			return false;
+
+		WorkQueue& queue = *queues[index];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.jobs.empty())
+			return false;
+
+		out = std::move(queue.jobs.back());
+		queue.jobs.pop_back();
+		return true;
+	}
+
+	bool ThreadPool::steal(size_t index, QueuedJob& out)
+	{
+		for (size_t i = 1; i <= queues.size(); ++i)
+		{
+			WorkQueue& queue = *queues[(index + i) % queues.size()];
+			std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+			if (!lock.owns_lock() || queue.jobs.empty())
+				continue;
+
+			out = std::move(queue.jobs.front());
+			queue.jobs.pop_front();
+			return true;
+		}
+		return false;
+	}
+
+	ThreadPool& threadPool()
+	{
+		static ThreadPool pool;
+		return pool;
+	}
+}
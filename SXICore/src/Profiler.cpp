@@ -0,0 +1,248 @@
+#include "Profiler.h"
+#include "Exception.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sxi::profiler
+{
+	namespace
+	{
+		struct Slot
+		{
+			std::atomic<const char*> name{};
+			std::atomic<const char*> detail{};
+			std::atomic<u64> begin{};
+			std::atomic<u64> end{};
+		};
+
+		struct Event
+		{
+			const char* name;
+			const char* detail;
+			u64 begin;
+			u64 end;
+			size_t thread;
+		};
+
+		/**
+		 * Ring of the most recent scopes of one thread. Only the owning thread
+		 * writes, readers copy the ring and drop what was overwritten meanwhile.
+		 */
+		struct ThreadBuffer
+		{
+			std::array<Slot, eventsPerThread> slots{};
+			std::atomic<u64> head{};
+			size_t id{};
+			std::string name{};
+		};
+
+		struct Registry
+		{
+			std::mutex mutex;
+			std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+			std::atomic<u64> clearedAt{};
+		};
+
+		Registry& registry()
+		{
+			static Registry instance;
+			return instance;
+		}
+
+		const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+		// shared with the registry, so scopes of finished threads are still exported.
+		// Created by the first recorded scope, so threads that never record while
+		// the profiler is enabled do not allocate a ring
+		thread_local std::shared_ptr<ThreadBuffer> currentBuffer;
+		// name given before the thread's ring exists
+		thread_local std::string currentName;
+
+		ThreadBuffer& threadBuffer()
+		{
+			if (!currentBuffer)
+			{
+				auto created = std::make_shared<ThreadBuffer>();
+				Registry& reg = registry();
+				std::lock_guard<std::mutex> lock(reg.mutex);
+				created->id = reg.buffers.size() + 1;
+				created->name = currentName.empty() ? "Thread " + std::to_string(created->id) : std::move(currentName);
+				reg.buffers.push_back(created);
+				currentBuffer = std::move(created);
+			}
+			return *currentBuffer;
+		}
+
+		void collect(const ThreadBuffer& buffer, u64 since, std::vector<Event>& events)
+		{
+			u64 head = buffer.head.load(std::memory_order_acquire);
+			u64 first = head > eventsPerThread ? head - eventsPerThread : 0;
+
+			size_t collected = events.size();
+			for (u64 i = first; i < head; ++i)
+			{
+				const Slot& slot = buffer.slots[i % eventsPerThread];
+				events.push_back(Event{
+					slot.name.load(std::memory_order_relaxed),
+					slot.detail.load(std::memory_order_relaxed),
+					slot.begin.load(std::memory_order_relaxed),
+					slot.end.load(std::memory_order_relaxed),
+					buffer.id });
+			}
+
+			// slots the owner started overwriting while they were copied are torn
+			std::atomic_thread_fence(std::memory_order_acquire);
+			u64 newHead = buffer.head.load(std::memory_order_relaxed);
+			u64 valid = newHead >= eventsPerThread ? newHead - eventsPerThread + 1 : 0;
+			size_t torn = SXI_TO_SIZE(std::min(head, std::max(first, valid)) - first);
+
+			events.erase(events.begin() + collected, events.begin() + collected + torn);
+			events.erase(std::remove_if(events.begin() + collected, events.end(), [since](const Event& event){
+				return event.begin < since;
+			}), events.end());
+		}
+
+		void writeString(std::ostream& out, std::string_view str)
+		{
+			out << '"';
+			for (char c : str)
+			{
+				if (c == '"' || c == '\\')
+					out << '\\' << c;
+				else if (static_cast<unsigned char>(c) < 0x20)
+					out << ' ';
+				else
+					out << c;
+			}
+			out << '"';
+		}
+
+		void writeMicroseconds(std::ostream& out, u64 nanoseconds)
+		{
+			out << nanoseconds / 1000 << '.';
+			u64 fraction = nanoseconds % 1000;
+			out << static_cast<char>('0' + fraction / 100) << static_cast<char>('0' + fraction / 10 % 10) << static_cast<char>('0' + fraction % 10);
+		}
+	}
+
+	void setEnabled(bool enable) noexcept
+	{
+		enabledFlag.store(enable, std::memory_order_relaxed);
+	}
+
+	void setThreadName(const std::string& name)
+	{
+		if (!currentBuffer)
+		{
+			currentName = name;
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(registry().mutex);
+		currentBuffer->name = name;
+	}
+
+	void clear() noexcept
+	{
+		registry().clearedAt.store(detail::now(), std::memory_order_relaxed);
+	}
+
+	void writeChromeTrace(std::ostream& out)
+	{
+		Registry& reg = registry();
+		std::vector<Event> events;
+		std::vector<std::pair<size_t, std::string>> threads;
+		{
+			std::lock_guard<std::mutex> lock(reg.mutex);
+			u64 since = reg.clearedAt.load(std::memory_order_relaxed);
+			for (const std::shared_ptr<ThreadBuffer>& buffer : reg.buffers)
+			{
+				collect(*buffer, since, events);
+				threads.emplace_back(buffer->id, buffer->name);
+			}
+		}
+
+		out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		bool first = true;
+		for (const auto& [id, name] : threads)
+		{
+			out << (first ? "\n" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << id << ",\"args\":{\"name\":";
+			writeString(out, name);
+			out << "}}";
+			first = false;
+		}
+		for (const Event& event : events)
+		{
+			out << (first ? "\n" : ",\n") << "{\"ph\":\"X\",\"cat\":\"sxi\",\"name\":";
+			writeString(out, event.name ? event.name : "");
+			out << ",\"pid\":1,\"tid\":" << event.thread << ",\"ts\":";
+			writeMicroseconds(out, event.begin);
+			out << ",\"dur\":";
+			writeMicroseconds(out, event.end - event.begin);
+			if (event.detail)
+			{
+				out << ",\"args\":{\"detail\":";
+				writeString(out, event.detail);
+				out << '}';
+			}
+			out << '}';
+			first = false;
+		}
+		out << "\n]}\n";
+	}
+
+	void writeChromeTrace(const std::string& path)
+	{
+		std::ofstream file(path, std::ios::trunc);
+		if (!file.is_open())
+			throw InvalidArgumentException("Failed to open trace file");
+
+		writeChromeTrace(file);
+		file.flush();
+		if (!file)
+			throw ResourceCreationException("Failed to write trace file");
+	}
+
+	u64 detail::now() noexcept
+	{
+		// never 0, which marks scopes opened while the profiler was disabled
+		return SXI_TO_U64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count()) + 1;
+	}
+
+	void detail::record(const char* name, const char* detail, u64 begin, u64 end) noexcept
+	{
+		ThreadBuffer& buffer = threadBuffer();
+		u64 head = buffer.head.load(std::memory_order_relaxed);
+		Slot& slot = buffer.slots[head % eventsPerThread];
+		slot.name.store(name, std::memory_order_relaxed);
+		slot.detail.store(detail, std::memory_order_relaxed);
+		slot.begin.store(begin, std::memory_order_relaxed);
+		slot.end.store(end, std::memory_order_relaxed);
+		buffer.head.store(head + 1, std::memory_order_release);
+	}
+
+	std::string detail::parseTypeName(std::string_view signature)
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		// const char *__cdecl sxi::profiler::detail::signature<struct Foo>(void) noexcept
+		size_t begin = signature.find("signature<") + 10;
+		size_t end = signature.rfind(">(");
+		std::string_view name = signature.substr(begin, end - begin);
+		for (std::string_view prefix : { "struct ", "class ", "enum " })
+			if (name.starts_with(prefix))
+				name.remove_prefix(prefix.size());
+#else
+		// ... signature() [with T = Foo; std::string_view = ...] or [T = Foo]
+		size_t begin = signature.find("T = ") + 4;
+		size_t end = signature.find_first_of(";]", begin);
+		std::string_view name = signature.substr(begin, end - begin);
+#endif
+		return std::string(name);
+	}
+}
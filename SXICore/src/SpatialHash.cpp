@@ -0,0 +1,72 @@
+#include "SpatialHash.h"
+
+#include <assert.h>
+#include <algorithm>
+
+namespace sxi
+{
+	SpatialHash::SpatialHash(float cellSize) : size(cellSize)
+	{
+		assert(cellSize > 0.f);
+	}
+
+	void SpatialHash::update(size_t id, const glm::vec3& point)
+	{
+		if (id >= keys.size())
+		{
+			keys.resize(id + 1, NO_KEY);
+			points.resize(id + 1);
+		}
+
+		points[id] = point;
+		uint64_t cellKey = key(cellCoord(point.x), cellCoord(point.y), cellCoord(point.z));
+		if (keys[id] == cellKey)
+			return;
+
+		if (keys[id] != NO_KEY)
+			removeFromCell(keys[id], id);
+		cells[cellKey].push_back(id);
+		keys[id] = cellKey;
+	}
+
+	void SpatialHash::remove(size_t id)
+	{
+		if (!contains(id))
+			return;
+
+		removeFromCell(keys[id], id);
+		keys[id] = NO_KEY;
+	}
+
+	void SpatialHash::truncate(size_t count)
+	{
+		for (size_t id = count; id < keys.size(); ++id)
+			remove(id);
+		if (count < keys.size())
+		{
+			keys.resize(count);
+			points.resize(count);
+		}
+	}
+
+	void SpatialHash::clear()
+	{
+		cells.clear();
+		points.clear();
+		keys.clear();
+	}
+
+	void SpatialHash::removeFromCell(uint64_t cellKey, size_t id)
+	{
+		auto it = cells.find(cellKey);
+		assert(it != cells.end());
+
+		std::vector<size_t>& ids = it->second;
+		auto found = std::find(ids.begin(), ids.end(), id);
+		assert(found != ids.end());
+		*found = ids.back();
+		ids.pop_back();
+		if (ids.empty())
+			cells.erase(it);
+	}
+}
@@ -6,6 +6,8 @@
 
 #include <algorithm>
 
+#include "SXICore/Profiler.h"
+
 namespace sxi
 {
 	Map::Map() : shapes(ShapeType::Count), cdt(std::make_unique<CDT>()), rst(std::make_unique<RST>()), initialized(false) {}
@@ -77,6 +79,7 @@ namespace sxi
 
 	std::vector<glm::vec2> Map::findPath(float x, float y, float gx, float gy) const
 	{
+		SXI_PROFILE_SCOPE("Map::findPath");
 		PAMetadata metadata;
 		glm::vec2 start, goal;
 		sxi::QuarterEdge* startBestEdge = rst->getBestEdge(glm::vec2(x, y), start);
@@ -88,6 +91,7 @@ namespace sxi
 
 	std::vector<glm::vec2> Map::findPath(const glm::vec2& tryStart, const glm::vec2& tryGoal) const
 	{
+		SXI_PROFILE_SCOPE("Map::findPath");
 		PAMetadata metadata;
 		glm::vec2 start, goal;
 		sxi::QuarterEdge* startBestEdge = rst->getBestEdge(tryStart, start);
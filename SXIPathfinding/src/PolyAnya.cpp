@@ -7,6 +7,7 @@
 #include <algorithm>
 
 #include "SXIMath/Line.h"
+#include "SXICore/Profiler.h"
 
 namespace sxi
 {
@@ -214,7 +215,11 @@ namespace sxi
 		} while (ptr != startEdge);
 		PolyAnya polyAnya(start, goal, startEdge, goalEdge);
 		std::chrono::steady_clock::time_point before = std::chrono::steady_clock::now();
-		std::vector<glm::vec2> retVal = polyAnya.run();
+		std::vector<glm::vec2> retVal;
+		{
+			SXI_PROFILE_SCOPE("PolyAnya::run");
+			retVal = polyAnya.run();
+		}
 		polyAnya.metadata.timeTaken = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - before);
 		metadata = polyAnya.metadata;
 		return retVal;
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "Scene.h"
+
+namespace sxi::renderer
+{
+    /**
+     * @brief Overlaps drawing a frame with simulating the next one.
+     * 
+     * Holds two FrameSnapshots and a dedicated render thread. submit captures the
+     * ECS into one snapshot on the calling thread and hands it to the render
+     * thread, which uploads and draws it while the caller already runs the next
+     * frame's systems. The caller only blocks when it is a whole frame ahead.
+     * 
+     * Must be destroyed before the renderer is.
+     */
+    class FramePipeline
+    {
+    public:
+        FramePipeline();
+        ~FramePipeline();
+
+        FramePipeline(const FramePipeline&) = delete;
+        FramePipeline& operator=(const FramePipeline&) = delete;
+
+        /**
+         * @brief Captures the frame and queues it for drawing.
+         * 
+         * Replaces render. Must be called only once per frame, before the
+         * manager is refreshed. Rethrows errors raised while drawing an
+         * earlier frame.
+         */
+        template <typename TSettings>
+        void submit(ecs::Manager<TSettings>& mgr)
+        {
+            // the render thread only ever reads the other snapshot
+            scene->capture(mgr, snapshots[writeIndex]);
+            publish();
+        }
+
+    private:
+        void publish();
+        void renderLoop();
+
+        std::array<FrameSnapshot, 2> snapshots{};
+        // snapshot submit captures into, the other one belongs to the render thread
+        size_t writeIndex{};
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        bool pending = false;
+        bool drawing = false;
+        bool stopping = false;
+        std::exception_ptr error{};
+
+        std::thread renderThread;
+    };
+}
@@ -3,17 +3,20 @@
 #include "detail/Context.h"
 
 #include <array>
+#include <span>
 #include <vector>
 
 #include <SXIMath/Mat.h>
 #include <SXIMath/Vec.h>
 #include <SXICore/Timing.h>
 #include <SXICore/Types.h>
+#include <SXICore/Profiler.h>
 #include <SXICore/ECS/Manager.h>
 
 #include <SXICore/components/PositionComponent.h>
-#include <SXICore/components/YRotationComponent.h>
+#include <SXICore/components/WorldTransformComponent.h>
 #include "components/RenderComponent.h"
+#include "resources/CameraResource.h"
 #include "tags/LightTag.h"
 
 #include "detail/Window.h"
@@ -36,12 +39,50 @@ namespace sxi::renderer
         alignas(16) glm::mat4 model;
     };
 
+    /**
+     * @brief Everything command recording needs to know about one renderable.
+     */
+    struct DrawItem
+    {
+        ecs::ModelIndex mdl;
+        ecs::TextureIndex tex;
+        size_t object;
+    };
+
+    /**
+     * @brief Render-relevant state of one frame, captured from the ECS.
+     *
+     * Uploading and command recording only read a snapshot, so they can run on
+     * another thread while the simulation already works on the next frame. A
+     * snapshot mirrors every object persistently and is brought up to date
+     * incrementally by Scene::capture.
+     */
+    struct FrameSnapshot
+    {
+        std::vector<DrawItem> drawList{};
+
+        // indexed by the object's entity index
+        std::vector<glm::mat4> models{};
+        // world version in which models[i] was last copied
+        std::vector<u64> changedVersions{};
+
+        glm::vec3 lightPosition{};
+        ecs::CameraResource camera{};
+
+        // world version this snapshot was captured at
+        u64 version{};
+        // world version the mirrored objects were last brought up to date with
+        u64 syncedVersion{};
+    };
+
     class Scene;
     class SceneData
     {
     public:
         VkDescriptorSet frameDescriptorSet{};
         std::vector<VkDescriptorSet> objectDescriptorSets{};
+        // snapshot version this frame's object UBOs were last brought up to date with
+        u64 syncedVersion{};
 
         SceneData() = default;
         SceneData(u8, u8);
@@ -61,38 +102,57 @@ class Scene
         Scene(u8);
         ~Scene() = default;
     
+        /**
+         * @brief Copies everything rendering needs into the snapshot. This is the
+         * only part of a frame touching the ECS.
+         *
+         * The world must list CameraResource in its ResourceList.
+         */
         template <typename TSettings>
-        void run(ecs::Manager<TSettings>& mgr, const Time& time)
+        void capture(ecs::Manager<TSettings>& mgr, FrameSnapshot& snapshot)
         {
-            u8 currentFrame = detail::context->currentFrame();
-            mgr.template forEntitiesMatching<ecs::Signature<ecs::PositionComponent, ecs::LightTag>>([this, &time, &currentFrame](auto&, auto& posComponent){
-                static TimePoint start = time.time;
-		        float timePassed = -Time::elapsed(time.time, start);
-
-                posComponent.pos = glm::vec3(100.f * std::sinf(timePassed), 30, 100.f * std::cosf(timePassed));
-
-                char* offset = (char*)detail::uniformBuffers[currentFrame].mapped;
-        
-                this->frameUBO.view = glm::lookAt(glm::vec3(0.f, 50.f, -75.f), glm::vec3(0.f, 20.f, 0.f), SXI_VEC3_UP);
-                this->frameUBO.proj = glm::perspective(glm::radians(60.0f), detail::window->swapchain->extent.width / (float) detail::window->swapchain->extent.height, 0.1f, 10000.0f);
-                this->frameUBO.proj[1][1] *= -1;
-                memcpy(offset, &this->frameUBO, sizeof(FrameUBO));
-
-                this->frameLight = FrameLight{ glm::vec4(posComponent.pos.x, posComponent.pos.y, posComponent.pos.z, 1.f) };
-                offset += sizeof(FrameUBO);
-                memcpy(offset, &this->frameLight, sizeof(FrameLight));
+            SXI_PROFILE_SCOPE("Scene::capture");
+            static_assert(TSettings::template isResource<ecs::CameraResource>(), "The world must hold a CameraResource to be rendered");
+
+            snapshot.camera = mgr.template resource<ecs::CameraResource>();
+            // read through the const manager so nothing is marked as changed
+            const ecs::Manager<TSettings>& readOnly = mgr;
+            readOnly.template forEntitiesMatching<ecs::Signature<ecs::PositionComponent, ecs::LightTag>>([&snapshot](auto&, auto&& posComponent){
+                const ecs::PositionComponent position = posComponent;
+                snapshot.lightPosition = position.pos;
             });
 
-            char* offset = (char*)detail::uniformBuffers[currentFrame].mapped + sizeof(FrameUBO) + sizeof(FrameLight);
-            mgr.template forEntitiesMatching<ecs::Signature<
-                ecs::PositionComponent,
-                ecs::YRotationComponent,
-                ecs::RenderComponent>>([this](auto& entityIndex, auto& posComponent, auto& rotComponent, auto&){
-                    this->objectUBOs[entityIndex].model = glm::rotate(glm::translate(glm::mat4(1.0f), posComponent.pos), rotComponent.rot, SXI_VEC3_UP);
+            // each snapshot buffer catches up separately
+            const u64 version = mgr.version();
+            readOnly.template forEntitiesChanged<ecs::Signature<
+                ecs::WorldTransformComponent,
+                ecs::RenderComponent>,
+                ecs::WorldTransformComponent>(snapshot.syncedVersion, [&snapshot, version](auto& entityIndex, const auto& worldComponent, const auto&){
+                    if (entityIndex >= snapshot.models.size())
+                    {
+                        snapshot.models.resize(entityIndex + 1);
+                        snapshot.changedVersions.resize(entityIndex + 1);
+                    }
+                    snapshot.models[entityIndex] = worldComponent.world;
+                    snapshot.changedVersions[entityIndex] = version;
                 });
-            memcpy(offset, objectUBOs.data(), objectUBOs.size() * sizeof(ObjectUBO));
+            snapshot.syncedVersion = version;
+            snapshot.version = version;
+
+            snapshot.drawList.clear();
+            readOnly.template forChunksMatching<ecs::Signature<ecs::RenderComponent>>([&snapshot](auto first, std::span<const ecs::RenderComponent> renderComponents){
+                for (size_t i = 0; i < renderComponents.size(); ++i)
+                    snapshot.drawList.push_back(DrawItem{ renderComponents[i].mdl, renderComponents[i].tex, first + i });
+            });
         }
 
+        /**
+         * @brief Writes the snapshot into the current frame in flight's uniform
+         * buffer. Only objects changed since that buffer was last written are
+         * recomputed.
+         */
+        void upload(const FrameSnapshot&);
+
         inline const SceneData& currentSceneData() const { return sceneDatas[detail::context->currentFrame()]; }
     private:
         FrameLight frameLight{};
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "SXIMath/Vec.h"
+
+namespace sxi::ecs
+{
+    /**
+     * @brief The world's view into the scene, stored once per Manager.
+     */
+    struct CameraResource final
+    {
+        glm::vec3 eye{ 0.f, 50.f, -75.f };
+        glm::vec3 target{ 0.f, 20.f, 0.f };
+        // vertical field of view in degrees
+        float fov = 60.f;
+        float nearPlane = 0.1f;
+        float farPlane = 10000.f;
+    };
+}
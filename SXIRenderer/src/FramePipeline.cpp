@@ -0,0 +1,75 @@
+#include "FramePipeline.h"
+#include "Renderer.h"
+
+#include "SXICore/Profiler.h"
+
+#include <utility>
+
+namespace sxi::renderer
+{
+	FramePipeline::FramePipeline()
+		: renderThread(&FramePipeline::renderLoop, this)
+	{
+	}
+
+	FramePipeline::~FramePipeline()
+	{
+		{
+			std::lock_guard lock(mutex);
+			stopping = true;
+		}
+		condition.notify_all();
+		renderThread.join();
+	}
+
+	void FramePipeline::publish()
+	{
+		SXI_PROFILE_SCOPE("FramePipeline::publish");
+
+		std::unique_lock lock(mutex);
+		// wait until the previous frame is drawn, its snapshot is captured into next
+		condition.wait(lock, [this]{ return (!pending && !drawing) || error; });
+		if (error)
+			std::rethrow_exception(std::exchange(error, nullptr));
+
+		pending = true;
+		writeIndex ^= 1;
+		lock.unlock();
+		condition.notify_all();
+	}
+
+	void FramePipeline::renderLoop()
+	{
+		profiler::setThreadName("Render");
+
+		while (true)
+		{
+			std::unique_lock lock(mutex);
+			condition.wait(lock, [this]{ return pending || stopping; });
+			if (!pending)
+				return;
+
+			pending = false;
+			drawing = true;
+			const FrameSnapshot& snapshot = snapshots[writeIndex ^ 1];
+			lock.unlock();
+
+			std::exception_ptr frameError{};
+			try
+			{
+				detail::renderFrame(snapshot);
+			}
+			catch (...)
+			{
+				frameError = std::current_exception();
+			}
+
+			lock.lock();
+			drawing = false;
+			if (frameError)
+				error = frameError;
+			lock.unlock();
+			condition.notify_all();
+		}
+	}
+}
@@ -13,10 +13,12 @@
 #include <SDL3/SDL_vulkan.h>
 #include <vulkan/vulkan.h>
 
+#include <array>
 #include <iostream>
 #include <vector>
 
 #include "SXICore/Exception.h"
+#include "SXICore/Profiler.h"
 
 namespace sxi::renderer
 {
@@ -252,6 +254,157 @@ namespace sxi::renderer
 		models.push_back(model);
 	}
 
+	void detail::recordCommandBuffer(const std::vector<DrawItem>& drawList, VkCommandBuffer commandBuffer, u32 imageIndex, u32 currentFrame)
+	{
+		SXI_PROFILE_SCOPE("recordCommandBuffer");
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = 0;
+		beginInfo.pInheritanceInfo = nullptr;
+		if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+			throw std::runtime_error("Failed to begin recording command buffer");
+
+		VkRenderPassBeginInfo renderPassInfo{};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+		renderPassInfo.renderPass = detail::basicRenderPass->pass;
+		renderPassInfo.framebuffer = detail::basicRenderPass->frameBuffers[imageIndex];
+		renderPassInfo.renderArea.offset = {0, 0};
+		renderPassInfo.renderArea.extent = detail::window->swapchain->extent;
+		std::array<VkClearValue, 2> clearValues{};
+		clearValues[0].color = {{0.01f, 0.01f, 0.01f, 1.0f}};
+		clearValues[1].depthStencil = {1.0f, 0};
+		renderPassInfo.clearValueCount = SXI_TO_U32(clearValues.size());
+		renderPassInfo.pClearValues = clearValues.data();
+
+		vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, detail::basicLightingPipeline->pipeline);
+
+		VkViewport viewport{};
+		viewport.x = 0.0f;
+		viewport.y = 0.0f;
+		viewport.width = static_cast<float>(detail::window->swapchain->extent.width);
+		viewport.height = static_cast<float>(detail::window->swapchain->extent.height);
+		viewport.minDepth = 0.0f;
+		viewport.maxDepth = 1.0f;
+		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+		VkRect2D scissor{};
+		scissor.offset = {0, 0};
+		scissor.extent = detail::window->swapchain->extent;
+		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+		const SceneData& sceneData = scene->currentSceneData();
+		vkCmdBindDescriptorSets(
+			commandBuffer,
+			VK_PIPELINE_BIND_POINT_GRAPHICS,
+			detail::basicLightingPipeline->layout,
+			detail::DescriptorSetType::PerFrame, 1,
+			&sceneData.frameDescriptorSet, 0, nullptr);
+
+		VkBuffer vertexBuffers[] = { detail::vertexBuffer->buffer };
+		for (const DrawItem& item : drawList)
+		{
+			Model* model = models[item.mdl];
+			VkDeviceSize offsets[] = { model->vertexBufferOffset };
+			vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+
+			vkCmdBindIndexBuffer(commandBuffer, detail::indexBuffer->buffer, model->indexBufferOffset, VK_INDEX_TYPE_UINT32);
+			vkCmdBindDescriptorSets(
+				commandBuffer,
+				VK_PIPELINE_BIND_POINT_GRAPHICS,
+				detail::basicLightingPipeline->layout,
+				detail::DescriptorSetType::PerModel, 1,
+				&textures[item.tex]->descriptorSet, 0, nullptr);
+
+			vkCmdBindDescriptorSets(
+				commandBuffer,
+				VK_PIPELINE_BIND_POINT_GRAPHICS,
+				detail::basicLightingPipeline->layout,
+				detail::DescriptorSetType::PerObject, 1,
+				&sceneData.objectDescriptorSets[item.object], 0, nullptr);
+
+			vkCmdDrawIndexed(commandBuffer, SXI_TO_U32(model->indices.size()), 1, 0, 0, 0);
+		}
+
+		vkCmdEndRenderPass(commandBuffer);
+
+		if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+			throw InvalidArgumentException("Failed to record command buffer");
+	}
+
+	void detail::renderFrame(const FrameSnapshot& snapshot)
+	{
+		SXI_PROFILE_SCOPE("renderFrame");
+
+		const detail::FrameContext* frameContext = detail::context->currentFrameContext();
+		{
+			SXI_PROFILE_SCOPE("waitForFence");
+			vkWaitForFences(detail::context->logicalDevice, 1, &frameContext->inFlightFence, VK_TRUE, UINT64_MAX);
+		}
+
+		// the GPU is done with this frame in flight, its uniform buffer may be rewritten
+		scene->upload(snapshot);
+		
+		u32 imageIndex;
+		{
+			SXI_PROFILE_SCOPE("acquireNextImage");
+			vkAcquireNextImageKHR(detail::context->logicalDevice, detail::window->swapchain->swapchain, UINT64_MAX, frameContext->imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
+		}
+		
+		vkResetFences(detail::context->logicalDevice, 1, &frameContext->inFlightFence);
+			
+		vkResetCommandBuffer(frameContext->commandBuffer, 0);
+		detail::recordCommandBuffer(snapshot.drawList, frameContext->commandBuffer, imageIndex, detail::context->currentFrame());
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+
+		VkSemaphore waitSemaphores[] = { frameContext->imageAvailableSemaphore };
+		VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+		submitInfo.waitSemaphoreCount = 1;
+		submitInfo.pWaitSemaphores = waitSemaphores;
+		submitInfo.pWaitDstStageMask = waitStages;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &frameContext->commandBuffer;
+
+		VkSemaphore signalSemaphores[] = { detail::window->swapchain->renderFinishedSemaphores[imageIndex] };
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = signalSemaphores;
+
+		{
+			SXI_PROFILE_SCOPE("queueSubmit");
+			if (vkQueueSubmit(detail::context->graphicsQueue, 1, &submitInfo, frameContext->inFlightFence) != VK_SUCCESS)
+				throw InvalidArgumentException("Failed to submit draw command buffer");
+		}
+
+		VkPresentInfoKHR presentInfo{};
+		presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+
+		presentInfo.waitSemaphoreCount = 1;
+		presentInfo.pWaitSemaphores = signalSemaphores;
+
+		VkSwapchainKHR swapChains[] = { detail::window->swapchain->swapchain };
+		presentInfo.swapchainCount = 1;
+		presentInfo.pSwapchains = swapChains;
+		presentInfo.pImageIndices = &imageIndex;
+		presentInfo.pResults = nullptr;
+
+		{
+			SXI_PROFILE_SCOPE("queuePresent");
+			vkQueuePresentKHR(detail::context->presentQueue, &presentInfo);
+		}
+
+		detail::context->advanceFrame();
+	}
+
+	FrameSnapshot& detail::immediateSnapshot()
+	{
+		static FrameSnapshot snapshot{};
+		return snapshot;
+	}
+
 	void destroy()
 	{
 		if (!initialized)
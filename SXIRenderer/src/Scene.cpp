@@ -4,6 +4,10 @@
 #include "detail/Buffer.h"
 
 #include "SXICore/Exception.h"
+#include "SXICore/Profiler.h"
+
+#include <algorithm>
+#include <cstring>
 
 namespace sxi::renderer
 {
@@ -101,4 +105,36 @@ namespace sxi::renderer
         for (size_t i = 0; i < sceneDatas.size(); ++i)
             sceneDatas[i] = SceneData(maxObjects, SXI_TO_U8(i));
     }
-}
\ No newline at end of file
+
+    void Scene::upload(const FrameSnapshot& snapshot)
+    {
+        SXI_PROFILE_SCOPE("Scene::upload");
+
+        u8 currentFrame = detail::context->currentFrame();
+        char* offset = (char*)detail::uniformBuffers[currentFrame].mapped;
+
+        const ecs::CameraResource& camera = snapshot.camera;
+        frameUBO.view = glm::lookAt(camera.eye, camera.target, SXI_VEC3_UP);
+        frameUBO.proj = glm::perspective(glm::radians(camera.fov), detail::window->swapchain->extent.width / (float) detail::window->swapchain->extent.height, camera.nearPlane, camera.farPlane);
+        frameUBO.proj[1][1] *= -1;
+        memcpy(offset, &frameUBO, sizeof(FrameUBO));
+
+        frameLight = FrameLight{ glm::vec4(snapshot.lightPosition, 1.f) };
+        offset += sizeof(FrameUBO);
+        memcpy(offset, &frameLight, sizeof(FrameLight));
+        offset += sizeof(FrameLight);
+
+        SceneData& sceneData = sceneDatas[currentFrame];
+        size_t objectCount = std::min(snapshot.models.size(), objectUBOs.size());
+        for (size_t i = 0; i < objectCount; ++i)
+        {
+            if (snapshot.changedVersions[i] < sceneData.syncedVersion)
+                continue;
+
+            ObjectUBO& objectUBO = objectUBOs[i];
+            objectUBO.model = snapshot.models[i];
+            memcpy(offset + i * sizeof(ObjectUBO), &objectUBO, sizeof(ObjectUBO));
+        }
+        sceneData.syncedVersion = snapshot.version;
+    }
+}
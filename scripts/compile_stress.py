@@ -0,0 +1,80 @@
+import os
+import subprocess
+import argparse
+import sys
+import json
+import time
+import tempfile
+
+def parse_args() -> dict:
+    parser = argparse.ArgumentParser(
+        prog="SXI Compile Stress Utility",
+        description="Compiles a single translation unit and reports how long it took and how much memory the compiler needed")
+    parser.add_argument("-v", "--version", help="Prints the version of the program.", action='version', version="%(prog)s 1.0")
+    parser.add_argument("source",
+                        help="Path to the translation unit to compile.")
+    parser.add_argument("--compiler",
+                        help="C++ compiler to invoke. Defaults to c++.",
+                        default="c++")
+    parser.add_argument("-I", "--include",
+                        help="Include directory, may be given several times.",
+                        action="append",
+                        default=[],
+                        dest="includes")
+    parser.add_argument("-o", "--output",
+                        help="Path of the JSON report. Only printed if omitted.",
+                        dest="output")
+    argv = sys.argv[1:]
+    if (len(argv) == 0):
+        argv = ["-h"]
+    args = vars(parser.parse_args(argv))
+    if not os.path.isfile(args["source"]):
+        parser.error("Source must be an existing file")
+    return args
+
+def is_msvc(compiler: str) -> bool:
+    name, _ = os.path.splitext(os.path.basename(compiler))
+    return name.lower() in {"cl", "clang-cl"}
+
+def compile_command(compiler: str, source: str, includes: list[str], object_file: str) -> list[str]:
+    if is_msvc(compiler):
+        return [compiler, "/nologo", "/std:c++20", "/O2", "/EHsc", "/c", source, "/Fo" + object_file] + ["/I" + include for include in includes]
+    return [compiler, "-std=c++20", "-O2", "-c", source, "-o", object_file] + ["-I" + include for include in includes]
+
+def peak_memory_mb() -> float | None:
+    try:
+        import resource
+    except ImportError:
+        return None
+    # kilobytes on Linux, bytes on macOS
+    peak = resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss
+    return peak / (1024 * 1024) if sys.platform == "darwin" else peak / 1024
+
+if __name__ == "__main__":
+    args = parse_args()
+    with tempfile.TemporaryDirectory() as temp_dir:
+        command = compile_command(args["compiler"], os.path.abspath(args["source"]), args["includes"], os.path.join(temp_dir, "stress.o"))
+        print(f"Compiling {os.path.basename(args['source'])}...", end=" ", flush=True)
+        start = time.perf_counter()
+        ret_val = subprocess.run(command, capture_output=True)
+        seconds = time.perf_counter() - start
+
+    if ret_val.returncode != 0:
+        print("FAILED")
+        print(ret_val.stderr.decode())
+        sys.exit(1)
+
+    memory = peak_memory_mb()
+    print("SUCCESS")
+    print(f"    Compile time: {seconds:.2f} s")
+    if memory is not None:
+        print(f"    Peak compiler memory: {memory:.0f} MB")
+
+    if args["output"] is not None:
+        with open(args["output"], "w") as report:
+            json.dump({
+                "source": os.path.abspath(args["source"]),
+                "compiler": args["compiler"],
+                "seconds": seconds,
+                "peakMemoryMB": memory
+            }, report, indent=4)